@@ -0,0 +1,237 @@
+#include "BKTree.h"
+#include "Levenshtein.h"
+#include <algorithm>
+
+namespace FuzzyWuzzy
+{
+	//---------------------------------------------------------------------------
+
+	template <typename CharT>
+	BasicBKTree<CharT>::BasicBKTree ( void ) :
+		_offsets ( 1 , 0 )
+	{
+	}
+
+	template <typename CharT>
+	BasicBKTree<CharT>::BasicBKTree ( const std::vector<String>& terms ) :
+		_offsets ( 1 , 0 )
+	{
+		size_t chars = 0;
+
+		for ( const String& term : terms )
+			chars += term.length();
+
+		_arena.reserve ( chars );
+		_offsets.reserve ( terms.size() + 1 );
+		_nodes.reserve ( terms.size() );
+
+		for ( const String& term : terms )
+			insert ( term );
+
+		_layout();
+	}
+
+	//---------------------------------------------------------------------------
+
+	template <typename CharT>
+	size_t BasicBKTree<CharT>::insert ( View term )
+	{
+		uint32_t id = (uint32_t) size();
+
+		_arena.append ( term.data() , term.length() );
+		_offsets.push_back ( _arena.length() );
+		_nodes.push_back ( { id , 0 , NONE , NONE , 0 } );
+
+		// term may view the arena (a term of this tree), which just moved
+		term = this->term ( id );
+
+		uint32_t added = (uint32_t) ( _nodes.size() - 1 );
+
+		if ( added == 0 )
+			return id;
+
+		uint32_t node = 0;
+
+		for ( ; ; )
+		{
+			View             other = this->term ( _nodes[node].id );
+			uint32_t         d     = (uint32_t) lev_edit_distance ( term.length() , term.data() ,
+																	 other.length() , other.data() , 0 );
+
+			// the children are linked in increasing edge order
+			uint32_t prev  = NONE;
+			uint32_t child = _nodes[node].first_child;
+
+			while ( child != NONE && _nodes[child].edge < d )
+			{
+				prev  = child;
+				child = _nodes[child].next_sibling;
+			}
+
+			if ( child != NONE && _nodes[child].edge == d )
+			{
+				node = child;
+				continue;
+			}
+
+			_nodes[added].edge         = d;
+			_nodes[added].next_sibling = child;
+
+			if ( prev == NONE )
+				_nodes[node].first_child = added;
+			else
+				_nodes[prev].next_sibling = added;
+
+			_nodes[node].max_edge = std::max ( _nodes[node].max_edge , d );
+
+			return id;
+		}
+	}
+
+	//---------------------------------------------------------------------------
+
+	/* Renumbers the nodes breadth first: the children of a node follow each
+	*   other in the array, in edge order
+	*/
+	template <typename CharT>
+	void BasicBKTree<CharT>::_layout ( void )
+	{
+		if ( _nodes.empty() )
+			return;
+
+		std::vector<Node>     nodes;
+		std::vector<uint32_t> order;   /* old index of the new node */
+
+		nodes.reserve ( _nodes.size() );
+		order.reserve ( _nodes.size() );
+		order.push_back ( 0 );
+		nodes.push_back ( _nodes[0] );
+
+		for ( size_t i = 0 ; i < order.size() ; i++ )
+		{
+			uint32_t child = _nodes[order[i]].first_child;
+
+			nodes[i].first_child = child == NONE ? NONE : (uint32_t) order.size();
+
+			while ( child != NONE )
+			{
+				order.push_back ( child );
+				nodes.push_back ( _nodes[child] );
+
+				child = _nodes[child].next_sibling;
+				nodes.back().next_sibling = child == NONE ? NONE : (uint32_t) order.size();
+			}
+		}
+
+		_nodes.swap ( nodes );
+	}
+
+	//---------------------------------------------------------------------------
+
+	/* Matches node against query and pushes its children within reach into
+	*   next. The distance only needs to be exact up to the farthest child.
+	*/
+	template <typename CharT>
+	void BasicBKTree<CharT>::_visit ( uint32_t node , View query , size_t k ,
+									  std::vector<BKTreeMatch>& matches , std::vector<uint32_t>& next ) const
+	{
+		const Node&      n     = _nodes[node];
+		View             other = term ( n.id );
+		size_t           max   = n.first_child == NONE ? k : n.max_edge + k;
+		size_t           d     = lev_edit_distance ( query.length() , query.data() ,
+													 other.length() , other.data() , 0 , max );
+
+		if ( d <= k )
+			matches.push_back ( { n.id , d } );
+
+		if ( d > max )
+			return;
+
+		for ( uint32_t child = n.first_child ; child != NONE ; child = _nodes[child].next_sibling )
+		{
+			size_t edge = _nodes[child].edge;
+
+			if ( edge + k < d )
+				continue;
+			if ( edge > d + k )
+				break;
+
+			next.push_back ( child );
+		}
+	}
+
+	template <typename CharT>
+	void BasicBKTree<CharT>::_search ( uint32_t node , View query , size_t k ,
+									   std::vector<BKTreeMatch>& matches ) const
+	{
+		std::vector<uint32_t> stack ( 1 , node );
+
+		while ( !stack.empty() )
+		{
+			node = stack.back();
+			stack.pop_back();
+
+			_visit ( node , query , k , matches , stack );
+		}
+	}
+
+	//---------------------------------------------------------------------------
+
+	static void _sort_matches ( std::vector<BKTreeMatch>& matches )
+	{
+		std::sort ( matches.begin() , matches.end() , [] ( const BKTreeMatch& a , const BKTreeMatch& b )
+		{
+			return a.distance != b.distance ? a.distance < b.distance : a.id < b.id;
+		});
+	}
+
+	template <typename CharT>
+	void BasicBKTree<CharT>::find ( View query , size_t k , std::vector<BKTreeMatch>& matches ) const
+	{
+		matches.clear();
+
+		if ( !_nodes.empty() )
+			_search ( 0 , query , k , matches );
+
+		_sort_matches ( matches );
+	}
+
+	template <typename CharT>
+	void BasicBKTree<CharT>::find ( ThreadPool& pool , View query , size_t k , std::vector<BKTreeMatch>& matches ) const
+	{
+		matches.clear();
+
+		if ( _nodes.empty() )
+			return;
+
+		// expand the top levels until there are subtrees enough for every thread
+		std::vector<uint32_t> frontier ( 1 , 0 );
+		std::vector<uint32_t> next;
+
+		while ( !frontier.empty() && frontier.size() < 4 * pool.size() )
+		{
+			next.clear();
+			for ( uint32_t node : frontier )
+				_visit ( node , query , k , matches , next );
+			frontier.swap ( next );
+		}
+
+		std::vector< std::vector<BKTreeMatch> > found ( pool.size() );
+
+		pool.parallel_for ( frontier.size() , [&] ( size_t index , size_t worker )
+		{
+			_search ( frontier[index] , query , k , found[worker] );
+		});
+
+		for ( const std::vector<BKTreeMatch>& part : found )
+			matches.insert ( matches.end() , part.begin() , part.end() );
+
+		_sort_matches ( matches );
+	}
+
+	//---------------------------------------------------------------------------
+
+	template class BasicBKTree<char>;
+	template class BasicBKTree<char16_t>;
+	template class BasicBKTree<char32_t>;
+}
@@ -0,0 +1,97 @@
+#ifndef BKTreeH
+#define BKTreeH
+
+#include "ThreadPool.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace FuzzyWuzzy
+{
+	struct BKTreeMatch
+	{
+		size_t id;         /* order of insertion */
+		size_t distance;
+	};
+
+	//---------------------------------------------------------------------------
+
+	/* Burkhard-Keller tree over the Levenshtein distance (lev_edit_distance with
+	*   xcost 0, the distance of SequenceMatcher::distance), for finding every
+	*   term within k edits of a query. The triangle inequality restricts the
+	*   children worth visiting to the edges in [d - k, d + k], d being the
+	*   distance to their parent.
+	*
+	*   The terms are copied into one buffer. The nodes are one flat array,
+	*   the children of a node linked in increasing edge order; building from
+	*   a list lays them out breadth first so that siblings are contiguous.
+	*   Terms inserted later are appended and linked in place. Duplicates are
+	*   kept, as children at distance 0.
+	*
+	*   find does not change the tree and may run on several threads at once,
+	*   but not concurrently with insert.
+	*
+	*   CharT is the character of lev_edit_distance: BKTree counts edits of
+	*   bytes, U16BKTree of UTF-16 code units and U32BKTree of code points.
+	*/
+	template <typename CharT>
+	class BasicBKTree
+	{
+	public:
+
+		typedef std::basic_string<CharT>      String;
+		typedef std::basic_string_view<CharT> View;
+
+	private :
+
+		static const uint32_t NONE = UINT32_MAX;
+
+		struct Node
+		{
+			uint32_t id;
+			uint32_t edge;           /* distance to the parent */
+			uint32_t first_child;
+			uint32_t next_sibling;
+			uint32_t max_edge;       /* largest edge of the children */
+		};
+
+		String                _arena;
+		std::vector<size_t>   _offsets;   /* term i is _arena[_offsets[i] .. _offsets[i + 1]) */
+		std::vector<Node>     _nodes;     /* _nodes[0] is the root */
+
+		void _layout ( void );
+		void _visit  ( uint32_t node , View query , size_t k ,
+					   std::vector<BKTreeMatch>& matches , std::vector<uint32_t>& next ) const;
+		void _search ( uint32_t node , View query , size_t k ,
+					   std::vector<BKTreeMatch>& matches ) const;
+
+	public:
+
+		BasicBKTree ( void );
+		explicit BasicBKTree ( const std::vector<String>& terms );
+
+		/* Adds term and returns its id */
+		size_t insert ( View term );
+
+		size_t size   ( void )      const { return _offsets.size() - 1; }
+		View   term   ( size_t id ) const { return View ( _arena ).substr ( _offsets[id] , _offsets[id + 1] - _offsets[id] ); }
+
+		/* The terms within k edits of query into matches, by distance and
+		*   then by id. The pool overload splits the tree between its threads.
+		*/
+		void find ( View query , size_t k , std::vector<BKTreeMatch>& matches ) const;
+		void find ( ThreadPool& pool , View query , size_t k , std::vector<BKTreeMatch>& matches ) const;
+	};
+
+	typedef BasicBKTree<char>     BKTree;
+	typedef BasicBKTree<char16_t> U16BKTree;
+	typedef BasicBKTree<char32_t> U32BKTree;
+
+	extern template class BasicBKTree<char>;
+	extern template class BasicBKTree<char16_t>;
+	extern template class BasicBKTree<char32_t>;
+}
+
+#endif
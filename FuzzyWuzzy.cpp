@@ -1,44 +1,224 @@
 #include "FuzzyWuzzy.h"
 #include "StringMatcher.h"
-#include "RegularExpressions/regexp/Matcher.h"
-#include "RegularExpressions/regexp/Pattern.h"
+#include "Tokenizer.h"
+#include "Unicode.h"
 #include <algorithm>
+#include <cctype>
 #include <iostream>
 #include <sstream>
 #include <vector>
-#include <set>
 
 namespace FuzzyWuzzy
 {
-	const std::string REG_TOKEN = "[\\w\\d]+";
-	Pattern* p = Pattern::compile ( REG_TOKEN );
+	/* m.ratio ( score_cutoff ) on the 0..100 scale. score_cutoff / 100 may
+	*   round above the ratio of a pair that scores exactly score_cutoff, so
+	*   the matcher gets a slightly lower cutoff and the score is checked here.
+	*/
+	template <typename Matcher>
+	static double _matcher_ratio ( Matcher& m , double score_cutoff )
+	{
+		double score = 100.0 * m.ratio ( std::max ( 0.0 , score_cutoff / 100.0 - 1e-7 ) );
+
+		return score >= score_cutoff ? score : 0;
+	}
 
 	//---------------------------------------------------------------------------
-	
+
 	double ratio ( const std::string& s1 , const std::string& s2 )
 	{
-		SequenceMatcher m ( s1 , s2 );
+		SequenceMatcherView m ( s1 , s2 );
 		return  100.0 * m.ratio();
 	}
 
 	//---------------------------------------------------------------------------
 
-	double partial_ratio ( const std::string& s1 , const std::string& s2 )
+	double ratio ( const std::string& s1 , const std::string& s2 , double score_cutoff )
+	{
+		SequenceMatcherView m ( s1 , s2 );
+		return _matcher_ratio ( m , score_cutoff );
+	}
+
+	//---------------------------------------------------------------------------
+
+	/* Indel ratio between the pattern in PM and s2, same as SequenceMatcher::ratio */
+	template <typename CharT>
+	static double _ratio ( const BlockPatternMatchVector& PM , std::basic_string_view<CharT> s2 )
 	{
-		std::string shorter, longer;
+		size_t lensum = PM.size() + s2.length();
 
-		if ( s1.length() <= s2.length())
+		if ( lensum == 0 )
+			return 1.0;
+
+		size_t ldist = lev_bitpal_distance ( PM , s2.length() , s2.data() , 1 );
+
+		return (double)(lensum - ldist)/(double)lensum;
+	}
+
+	//---------------------------------------------------------------------------
+
+	static double _cutoff ( double score , double score_cutoff )
+	{
+		return score >= score_cutoff ? score : 0;
+	}
+
+	//---------------------------------------------------------------------------
+
+	/* Slot of a character in the histograms of partial_ratio. Code points share
+	*   the 256 slots, which only loosens the bounds taken from the counts.
+	*/
+	static inline unsigned char _bucket ( char ch )     { return (unsigned char) ch; }
+	static inline unsigned char _bucket ( char16_t ch ) { return (unsigned char) ( ch ^ ( ch >> 8 ) ); }
+	static inline unsigned char _bucket ( char32_t ch ) { return (unsigned char) ( ch ^ ( ch >> 8 ) ^ ( ch >> 16 ) ); }
+
+	//---------------------------------------------------------------------------
+
+	/* Upper bound of the score of a window of len characters sharing at most
+	*   common characters with a pattern of len1, rounded like the scores
+	*/
+	static double _partial_bound ( size_t common , size_t len1 , size_t len )
+	{
+		double r = 2.0 * (double)std::min ( common , std::min ( len1 , len ) ) / (double)( len1 + len );
+
+		return r > 0.995 ? 100.0 : r * 100.0;
+	}
+
+	/* only windows that can beat the best one so far and reach the cutoff */
+	static bool _partial_worth ( double bound , const ScoreAlignment& best , double score_cutoff )
+	{
+		return bound > best.score && bound >= score_cutoff;
+	}
+
+	//---------------------------------------------------------------------------
+
+	/* Updates best with the window longer[start, start + len) aligned to all
+	*   of shorter. Returns true once the window scores 100.
+	*/
+	template <typename CharT>
+	static bool _partial_window ( const BlockPatternMatchVector& PM , std::basic_string_view<CharT> longer ,
+								  size_t start , size_t len , ScoreAlignment& best )
+	{
+		double r = _ratio ( PM , longer.substr ( start , len ) );
+
+		if ( r > 0.995 )
+			r = 1.0;
+
+		if ( r * 100.0 > best.score )
 		{
-			shorter = s1; longer = s2;
+			best.score      = r * 100.0;
+			best.dest_start = start;
+			best.dest_end   = start + len;
 		}
-		else
+
+		return r == 1.0;
+	}
+
+	//---------------------------------------------------------------------------
+
+	/* Slides shorter over longer, including the windows that only partially
+	*   overlap it at both ends. A window whose outer character does not occur
+	*   in shorter scores below the window one character shorter, so only the
+	*   others are computed, and only when the characters they share with
+	*   shorter, counted while sliding, allow them to beat the best window so
+	*   far and the cutoff.
+	*/
+	template <typename CharT>
+	static ScoreAlignment _partial_ratio_short ( std::basic_string_view<CharT> shorter , std::basic_string_view<CharT> longer ,
+												 const BlockPatternMatchVector& PM , double score_cutoff )
+	{
+		size_t         len1 = shorter.length();
+		size_t         len2 = longer.length();
+		uint32_t       count1[256] = { 0 };
+		uint32_t       window[256] = { 0 };
+		size_t         common = 0;
+		ScoreAlignment best = { 0 , 0 , len1 , 0 , len1 };
+
+		for ( size_t i = 0 ; i < len1 ; i++ )
+			count1[ _bucket ( shorter[i] ) ]++;
+
+		// longer[0, i)
+		for ( size_t i = 1 ; i < len1 ; i++ )
+		{
+			unsigned char add = _bucket ( longer[i - 1] );
+
+			if ( window[add]++ < count1[add] )
+				common++;
+
+			if ( count1[add] && _partial_worth ( _partial_bound ( common , len1 , i ) , best , score_cutoff )
+				 && _partial_window ( PM , longer , 0 , i , best ) )
+				return best;
+		}
+
+		// longer[i, i + len1)
+		for ( size_t i = 0 ; i + len1 <= len2 ; i++ )
+		{
+			unsigned char add = _bucket ( longer[i + len1 - 1] );
+
+			if ( i > 0 )
+			{
+				unsigned char drop = _bucket ( longer[i - 1] );
+
+				if ( --window[drop] < count1[drop] )
+					common--;
+			}
+			if ( window[add]++ < count1[add] )
+				common++;
+
+			if ( count1[add] && _partial_worth ( _partial_bound ( common , len1 , len1 ) , best , score_cutoff )
+				 && _partial_window ( PM , longer , i , len1 , best ) )
+				return best;
+		}
+
+		// longer[i, len2)
+		for ( size_t i = len2 - len1 + 1 ; i < len2 ; i++ )
 		{
-			shorter = s2; longer = s1;
+			unsigned char drop  = _bucket ( longer[i - 1] );
+			unsigned char first = _bucket ( longer[i] );
+
+			if ( --window[drop] < count1[drop] )
+				common--;
+
+			if ( count1[first] && _partial_worth ( _partial_bound ( common , len1 , len2 - i ) , best , score_cutoff )
+				 && _partial_window ( PM , longer , i , len2 - i , best ) )
+				return best;
 		}
 
-		SequenceMatcher m ( shorter, longer);
+		return best;
+	}
+
+	//---------------------------------------------------------------------------
+
+	/* Sliding every window is quadratic in the length of shorter once it
+	*   spans several words, so long patterns only try the windows that line
+	*   up with a matching block, as python's fuzzywuzzy does. Blocks on the
+	*   same diagonal share their window, which is scored once.
+	*/
+	template <typename CharT>
+	static ScoreAlignment _partial_ratio_long ( std::basic_string_view<CharT> shorter , std::basic_string_view<CharT> longer ,
+												const BlockPatternMatchVector& PM , double score_cutoff )
+	{
+		/* the blocks live in the thread scratch, the ratios below only use its
+		*   distance buffers
+		*/
+		LevScratch&                          scratch = lev_thread_scratch();
+		const std::vector<LevMatchingBlock>& blocks  = scratch.blocks;
+		size_t                               len1    = shorter.length();
+		uint32_t                             count1[256] = { 0 };
+		uint32_t                             window[256] = { 0 };
+		size_t                               common  = 0;
+		size_t                               start   = 0;
+		size_t                               end     = 0;
+		ScoreAlignment                       best    = { 0 , 0 , len1 , 0 , len1 };
+
+		static thread_local std::vector<bool> tried;
+
+		tried.assign ( longer.length() + 1 , false );
 
-		std::vector<Triple>* blocks = m.get_matching_blocks();
+		for ( size_t i = 0 ; i < len1 ; i++ )
+			count1[ _bucket ( shorter[i] ) ]++;
+
+		lev_matching_blocks ( shorter.length() , shorter.data() ,
+							  longer.length()  , longer.data() ,
+							  scratch.blocks , scratch );
 
 		/* each block represents a sequence of matching characters in a string
 		* of the form (idx_1, idx_2, len)
@@ -47,68 +227,235 @@ namespace FuzzyWuzzy
 		*   block = (1,3,3)
 		*   best score === ratio("abcd", "Xbcd")
 		*/
-		double max = -1.0;
-
-		for ( std::vector<Triple>::const_iterator it = blocks->begin(); it != blocks->end() ; ++it )
+		for ( size_t i = 0 ; i < blocks.size() ; i++ )
 		{
-			Triple block = *it;
+			const LevMatchingBlock& block = blocks[i];
+
+			size_t long_start = ( block.dpos > block.spos ) ? block.dpos - block.spos : 0;
+			size_t long_len   = std::min ( len1 , longer.length() - long_start );
+
+			if ( tried[long_start] )
+				continue;
+			tried[long_start] = true;
+
+			if ( !_partial_worth ( _partial_bound ( len1 , len1 , long_len ) , best , score_cutoff ) )
+				continue;
+
+			// move the counted window [start, end) there
+			for ( ; end < long_start + long_len ; end++ )
+				if ( window[ _bucket ( longer[end] ) ]++ < count1[ _bucket ( longer[end] ) ] )
+					common++;
+			for ( ; start > long_start ; start-- )
+				if ( window[ _bucket ( longer[start - 1] ) ]++ < count1[ _bucket ( longer[start - 1] ) ] )
+					common++;
+			for ( ; start < long_start ; start++ )
+				if ( --window[ _bucket ( longer[start] ) ] < count1[ _bucket ( longer[start] ) ] )
+					common--;
+			for ( ; end > long_start + long_len ; end-- )
+				if ( --window[ _bucket ( longer[end - 1] ) ] < count1[ _bucket ( longer[end - 1] ) ] )
+					common--;
+
+			if ( _partial_worth ( _partial_bound ( common , len1 , long_len ) , best , score_cutoff )
+				 && _partial_window ( PM , longer , long_start , long_len , best ) )
+				break;
+		}
 
-			int         long_start  = ( block[1] - block[0] > 0 ) ? block[1] - block[0] : 0;
-			int         long_end    = long_start + shorter.length();
-			std::string long_substr = longer.substr ( long_start , long_end - long_start );
+		return best;
+	}
 
-			SequenceMatcher m2 ( shorter , long_substr );
-			
-			double r = m2.ratio();
+	//---------------------------------------------------------------------------
 
-			if ( r > 0.995 )
-			{
-				return 100.0;
-			}
-			else if ( r > max || max < 0 )
+	/* PM holds the pattern masks of shorter, the alignment is shorter's.
+	*   Windows below score_cutoff (0..100) are skipped, and so is everything
+	*   once the characters of longer cannot reach it.
+	*/
+	template <typename CharT>
+	static ScoreAlignment _partial_ratio ( std::basic_string_view<CharT> shorter , std::basic_string_view<CharT> longer ,
+										   const BlockPatternMatchVector& PM , double score_cutoff )
+	{
+		ScoreAlignment best;
+
+		if ( shorter.empty() )
+		{
+			ScoreAlignment empty = { 100.0 , 0 , 0 , 0 , 0 };
+			return empty;
+		}
+
+		if ( score_cutoff > 0 )
+		{
+			size_t count1[256] = { 0 };
+			size_t common = 0;
+
+			for ( size_t i = 0 ; i < shorter.length() ; i++ )
+				count1[ _bucket ( shorter[i] ) ]++;
+			for ( size_t i = 0 ; i < longer.length() ; i++ )
+				if ( count1[ _bucket ( longer[i] ) ] )
+				{
+					count1[ _bucket ( longer[i] ) ]--;
+					common++;
+				}
+
+			// windows shorter than the pattern may score higher, at best the
+			// window made of exactly the common characters
+			if ( _partial_bound ( common , shorter.length() , common ) < score_cutoff )
 			{
-				max = r;
+				ScoreAlignment none = { 0 , 0 , shorter.length() , 0 , shorter.length() };
+				return none;
 			}
 		}
 
-		return  max * 100.0;
+		if ( shorter.length() <= 64 )
+			best = _partial_ratio_short ( shorter , longer , PM , score_cutoff );
+		else
+			best = _partial_ratio_long  ( shorter , longer , PM , score_cutoff );
+
+		best.score = _cutoff ( best.score , score_cutoff );
+
+		return best;
+	}
+
+	template <typename CharT>
+	static ScoreAlignment _partial_ratio ( std::basic_string_view<CharT> shorter , std::basic_string_view<CharT> longer , double score_cutoff )
+	{
+		static thread_local BlockPatternMatchVector PM;
+
+		PM.insert ( shorter.length() , shorter.data() );
+
+		return _partial_ratio ( shorter , longer , PM , score_cutoff );
+	}
+
+	/* the alignment of _partial_ratio ( s2 , s1 ) seen from s1 */
+	static ScoreAlignment _swapped ( ScoreAlignment alignment )
+	{
+		std::swap ( alignment.src_start , alignment.dest_start );
+		std::swap ( alignment.src_end   , alignment.dest_end   );
+
+		return alignment;
 	}
 
 	//---------------------------------------------------------------------------
 
-	void sorted ( std::vector<std::string>& vector )
+	double partial_ratio ( const std::string& s1 , const std::string& s2 )
 	{
-		sort ( vector.begin() , vector.end() );
+		return partial_ratio_alignment ( s1 , s2 ).score;
 	}
 
 	//---------------------------------------------------------------------------
 
-	std::string trim ( const std::string& str,
-					   const std::string& whitespace = " \t")
+	double partial_ratio ( const std::string& s1 , const std::string& s2 , double score_cutoff )
 	{
-		const auto strBegin = str.find_first_not_of(whitespace);
-		if (strBegin == std::string::npos)
-			return ""; // no content
+		return partial_ratio_alignment ( s1 , s2 , score_cutoff ).score;
+	}
+
+	//---------------------------------------------------------------------------
 
-		const auto strEnd   = str.find_last_not_of(whitespace);
-		const auto strRange = strEnd - strBegin + 1;
+	template <typename CharT>
+	static ScoreAlignment _partial_ratio_alignment ( std::basic_string_view<CharT> s1 , std::basic_string_view<CharT> s2 ,
+													 double score_cutoff )
+	{
+		if ( s1.length() <= s2.length())
+			return _partial_ratio ( s1 , s2 , score_cutoff );
+		else
+			return _swapped ( _partial_ratio ( s2 , s1 , score_cutoff ) );
+	}
 
-		return str.substr(strBegin, strRange);
+	ScoreAlignment partial_ratio_alignment ( const std::string& s1 , const std::string& s2 , double score_cutoff )
+	{
+		return _partial_ratio_alignment<char> ( s1 , s2 , score_cutoff );
 	}
 
 	//---------------------------------------------------------------------------
 
-	std::string join ( const std::vector<std::string>& v , const std::string& token = " " )
+	/* removes the leading and trailing spaces and tabs in place */
+	template <typename CharT>
+	void trim ( std::basic_string<CharT>& str )
 	{
-		std::string result;
-		
-		for (std::vector<std::string>::const_iterator i = v.begin(); i != v.end(); i++)
+		static const CharT whitespace[] = { ' ' , '\t' , 0 };
+
+		const auto strEnd = str.find_last_not_of(whitespace);
+		if (strEnd == std::basic_string<CharT>::npos)
 		{
-			if (i != v.begin()) result += token;
-			result += trim ( *i );
+			str.clear(); // no content
+			return;
 		}
 
-		return trim ( result );
+		str.erase(strEnd + 1);
+		str.erase(0, str.find_first_not_of(whitespace));
+	}
+
+	//---------------------------------------------------------------------------
+
+	/* the tokens of s in order, repeats included */
+	template <typename CharT>
+	void _token_views ( const std::basic_string<CharT>& s , std::vector< std::basic_string_view<CharT> >& views )
+	{
+		static thread_local std::vector<TokenSpan> spans;
+
+		find_tokens ( s.data() , s.length() , spans );
+
+		views.clear();
+
+		for ( std::vector<TokenSpan>::const_iterator it = spans.begin(); it != spans.end(); ++it )
+			views.push_back ( std::basic_string_view<CharT> ( s.data() + it->offset , it->length ) );
+	}
+
+	//---------------------------------------------------------------------------
+
+	/* appends token to joined, separated by a space unless joined is empty */
+	template <typename CharT>
+	void _append_token ( std::basic_string<CharT>& joined , std::basic_string_view<CharT> token )
+	{
+		if ( !joined.empty() )
+			joined += CharT(' ');
+
+		joined.append ( token.data() , token.length() );
+	}
+
+	//---------------------------------------------------------------------------
+
+	template <typename CharT>
+	void _join_tokens ( const std::vector< std::basic_string_view<CharT> >& views , std::basic_string<CharT>& joined )
+	{
+		joined.clear();
+
+		for ( auto it = views.begin(); it != views.end(); ++it )
+			_append_token ( joined , *it );
+	}
+
+	//---------------------------------------------------------------------------
+
+	/* the tokens of s, sorted and joined by spaces, into joined. Passing the
+	*   same string every time keeps this off the allocator.
+	*/
+	template <typename CharT>
+	void _sorted_tokens ( const std::basic_string<CharT>& s , std::basic_string<CharT>& joined )
+	{
+		static thread_local std::vector< std::basic_string_view<CharT> > views;
+
+		_token_views ( s , views );
+
+		std::sort ( views.begin() , views.end() );
+
+		_join_tokens ( views , joined );
+	}
+
+	template <typename CharT>
+	std::basic_string<CharT> _sorted_tokens ( const std::basic_string<CharT>& s )
+	{
+		std::basic_string<CharT> joined;
+
+		_sorted_tokens ( s , joined );
+
+		return joined;
+	}
+
+	//---------------------------------------------------------------------------
+
+	template <typename CharT>
+	static double _ratio ( std::basic_string_view<CharT> s1 , std::basic_string_view<CharT> s2 , double score_cutoff = 0 )
+	{
+		BasicSequenceMatcherView<CharT> m ( s1 , s2 );
+		return _matcher_ratio ( m , score_cutoff );
 	}
 
 	//---------------------------------------------------------------------------
@@ -119,28 +466,17 @@ namespace FuzzyWuzzy
 	*   controls for unordered string elements
 	*/
 
-	double _token_sort ( const std::string& s1 , const std::string& s2 , bool partial )
+	template <typename CharT>
+	double _token_sort ( const std::basic_string<CharT>& s1 , const std::basic_string<CharT>& s2 , bool partial )
 	{
-		Matcher* m1 = p->createMatcher ( s1 );
-		Matcher* m2 = p->createMatcher ( s2 );
-
-		// pull tokens
-		std::vector<std::string> tokens1 = m1->findAll();
-		std::vector<std::string> tokens2 = m2->findAll();
-
-		delete m1;
-		delete m2;
-
-		// sort tokens and join
-		sorted ( tokens1 );
-		sorted ( tokens2 );
+		static thread_local std::basic_string<CharT> sorted1 , sorted2;
 
-		std::string sorted1 = trim ( join ( tokens1 ) );
-		std::string sorted2 = trim ( join ( tokens2 ) );
+		_sorted_tokens ( s1 , sorted1 );
+		_sorted_tokens ( s2 , sorted2 );
 
 		return partial ?
-			partial_ratio ( sorted1 , sorted2 ) :
-			        ratio ( sorted1 , sorted2 );
+			_partial_ratio_alignment<CharT> ( sorted1 , sorted2 , 0 ).score :
+			                  _ratio<CharT> ( sorted1 , sorted2 );
 
 	}
 
@@ -160,12 +496,42 @@ namespace FuzzyWuzzy
 
 	//-------------------------------------------------------------------------
 
-	void _set ( std::vector<std::string>& v )
+	/* interns the sorted views, so that the ids sort the same way as the tokens */
+	template <typename CharT>
+	void _intern_tokens ( BasicTokenDictionary<CharT>& dict , const std::vector< std::basic_string_view<CharT> >& views )
+	{
+		dict.clear();
+
+		for ( auto it = views.begin(); it != views.end(); ++it )
+			dict.intern ( *it );
+	}
+
+	/* interns the distinct tokens of s in sorted order */
+	template <typename CharT>
+	void _intern_token_set ( BasicTokenDictionary<CharT>& dict , const std::basic_string<CharT>& s )
+	{
+		static thread_local std::vector< std::basic_string_view<CharT> > views;
+
+		_token_views ( s , views );
+
+		std::sort ( views.begin() , views.end() );
+
+		_intern_tokens ( dict , views );
+	}
+
+	//-------------------------------------------------------------------------
+
+	/* ratio between a string of prefix_len characters and one of len that
+	*   starts with it: the Indel distance is the difference of the lengths
+	*/
+	static double _prefix_ratio ( size_t prefix_len , size_t len )
 	{
-		std::set<std::string> s;
-		unsigned size = v.size();
-		for( unsigned i = 0; i < size; ++i ) s.insert( v[i] );
-		v.assign( s.begin(), s.end() );
+		size_t lensum = prefix_len + len;
+
+		if ( lensum == 0 )
+			return 100.0;
+
+		return 100.0 * ( (double)(2 * prefix_len) / (double)lensum );
 	}
 
 	//-------------------------------------------------------------------------
@@ -176,98 +542,122 @@ namespace FuzzyWuzzy
 	*       <sorted_intersection><sorted_remainder>
 	*   take ratios of those two strings
 	*   controls for unordered partial matches
+	*
+	*   tokens1 holds the token set of s1 (see _intern_token_set): looking the
+	*   tokens of s2 up splits its ids into the intersection and the remainder
+	*   of s1, only the tokens s1 lacks are compared as strings. Both combined
+	*   strings are built in per-thread buffers, the intersection is their
+	*   common prefix.
+	*
+	*   When either set contains the other, a combined string equals the
+	*   intersection and the score is 100. Otherwise the intersection's ratios
+	*   follow from the lengths, and only the two combined strings need the
+	*   distance, with the better of those ratios or score_cutoff as cutoff.
+	*   Below score_cutoff the result may be anything below it.
+	*
+	*   The partial scorers share it: the original never read its partial
+	*   flag, so partial_token_set_ratio scores as token_set_ratio.
 	*/
-	double _token_set ( const std::string& s1 , const std::string& s2 , bool partial )
+	template <typename CharT>
+	double _token_set ( const BasicTokenDictionary<CharT>&                    tokens1 ,
+						const std::vector< std::basic_string_view<CharT> >& tokens2 ,
+						double                                               score_cutoff = 0 )
 	{
-		Matcher* m1 = p->createMatcher ( s1 );
-		Matcher* m2 = p->createMatcher ( s2 );
+		typedef std::basic_string<CharT>      String;
+		typedef std::basic_string_view<CharT> View;
+
+		static thread_local std::vector<uint8_t> shared;   /* by id of tokens1 */
+		static thread_local std::vector<View>    rest2;
+		static thread_local String               combined_1to2 , combined_2to1;
 
-		// pull tokens
-		std::vector<std::string> v_tokens1 = m1->findAll();
-		std::vector<std::string> v_tokens2 = m2->findAll();
+		size_t shared_count = 0;
 
-		delete m1;
-		delete m2;
+		shared.assign ( tokens1.size() , 0 );
+		rest2.clear();
 
-		_set   ( v_tokens1 );
-		_set   ( v_tokens2 );
-		sorted ( v_tokens1 );
-		sorted ( v_tokens2 );
+		for ( auto it = tokens2.begin(); it != tokens2.end(); ++it )
+		{
+			uint32_t id = tokens1.find ( *it );
+
+			if ( id == BasicTokenDictionary<CharT>::npos )
+				rest2.push_back ( *it );
+			else if ( !shared[id] )
+			{
+				shared[id] = 1;
+				shared_count++;
+			}
+		}
+
+		if ( shared_count == tokens1.size() || rest2.empty() )
+			return 100.0;
 
+		std::sort ( rest2.begin() , rest2.end() );
+		rest2.erase ( std::unique ( rest2.begin() , rest2.end() ) , rest2.end() );
 
-		std::vector<std::string>::iterator it;
-		std::vector<std::string> intersection ( std::min ( v_tokens1.size() , v_tokens2.size() ) );
-		std::vector<std::string> diff1to2     ( v_tokens1.size() );
-		std::vector<std::string> diff2to1     ( v_tokens2.size() );
+		combined_1to2.clear();
 
-		it = set_intersection   ( v_tokens1.begin() , v_tokens1.end() ,
-								  v_tokens2.begin() , v_tokens2.end() ,
-								  intersection.begin() );
+		for ( uint32_t id = 0; id < tokens1.size(); ++id )
+			if ( shared[id] )
+				_append_token ( combined_1to2 , tokens1.token ( id ) );
 
-		it = set_difference 	( v_tokens1.begin() , v_tokens1.end() ,
-								  v_tokens2.begin() , v_tokens2.end() ,
-								  diff1to2.begin() );
+		size_t sect_len = combined_1to2.length();
 
-		it = set_difference 	( v_tokens2.begin() , v_tokens2.end() ,
-								  v_tokens1.begin() , v_tokens1.end() ,
-								  diff2to1.begin()  );
+		combined_2to1 = combined_1to2;
 
-		sorted ( intersection );
-		sorted ( diff1to2     );
-		sorted ( diff2to1     );
+		for ( uint32_t id = 0; id < tokens1.size(); ++id )
+			if ( !shared[id] )
+				_append_token ( combined_1to2 , tokens1.token ( id ) );
 
-		std::string sorted_sect = join ( intersection );
-		std::string sorted_1to2 = join ( diff1to2     );
-		std::string sorted_2to1 = join ( diff2to1     );
+		for ( auto it = rest2.begin(); it != rest2.end(); ++it )
+			_append_token ( combined_2to1 , *it );
 
-		std::string combined_1to2 = sorted_sect + " " + sorted_1to2;
-		std::string combined_2to1 = sorted_sect + " " + sorted_2to1;
+		double sect = std::max ( _prefix_ratio ( sect_len , combined_1to2.length() ) ,
+								 _prefix_ratio ( sect_len , combined_2to1.length() ) );
+
+		return std::max ( sect , _ratio<CharT> ( combined_1to2 , combined_2to1 , std::max ( sect , score_cutoff ) ) );
+	}
 
-		// Trim
-		sorted_sect   = trim ( sorted_sect   );
-		combined_1to2 = trim ( combined_1to2 );
-		combined_2to1 = trim ( combined_2to1 );
+	//-------------------------------------------------------------------------
 
-		std::vector<double> pairwise;
+	template <typename CharT>
+	double _token_set ( const std::basic_string<CharT>& s1 , const std::basic_string<CharT>& s2 )
+	{
+		static thread_local BasicTokenDictionary<CharT>                   tokens1;
+		static thread_local std::vector< std::basic_string_view<CharT> > tokens2;
 
-		pairwise.push_back ( ratio ( sorted_sect   , combined_1to2 ) );
-		pairwise.push_back ( ratio ( sorted_sect   , combined_2to1 ) );
-		pairwise.push_back ( ratio ( combined_1to2 , combined_2to1 ) );
+		_intern_token_set ( tokens1 , s1 );
+		_token_views      ( s2 , tokens2 );
 
-		return *max_element ( pairwise.begin() , pairwise.end() );
+		return _token_set ( tokens1 , tokens2 );
 	}
 
 	//-------------------------------------------------------------------------
 
 	double token_set_ratio ( const std::string& s1 , const std::string& s2 )
 	{
-		return _token_set ( s1 , s2 , false );
+		return _token_set ( s1 , s2 );
 	}
 
 	//-------------------------------------------------------------------------
 
 	double partial_token_set_ratio ( const std::string& s1 , const std::string& s2 )
 	{
-		return _token_set ( s1 , s2 , true );
+		return _token_set ( s1 , s2 );
 	}
 
 	//-------------------------------------------------------------------------
 	
-	double WRatio ( const std::string& s1 , const std::string& s2 )
-	{
-		// Validate string
-		if ( s1.length() == 0 || s2.length() == 0 )
-			return 0;
+	const double WRATIO_UNBASE_SCALE = 0.95;
 
-		// should we look at partials?
-		bool   try_partial   = true;
-		double unbase_scale  = 0.95;
-		double partial_scale = 0.90;
+	/* should we look at partials? partial_scale receives their weight */
+	bool _wratio_partial ( size_t len1 , size_t len2 , double& partial_scale )
+	{
+		bool try_partial = true;
 
-		double base = ratio ( s1 , s2 );
+		partial_scale = 0.90;
 
-		double len_ratio = (double) std::max ( s1.length() , s2.length() ) /
-						   (double) std::min ( s1.length() , s2.length() );
+		double len_ratio = (double) std::max ( len1 , len2 ) /
+						   (double) std::min ( len1 , len2 );
 
 		// if strings are similar length, don't use partials
 		if ( len_ratio < 1.5 ) try_partial = false;
@@ -275,24 +665,743 @@ namespace FuzzyWuzzy
 		// if one string is much much shorter than the other
 		if ( len_ratio > 8 )  partial_scale = 0.6;
 
+		return try_partial;
+	}
+
+	//-------------------------------------------------------------------------
+
+	/* whether a sub-score of at most bound can still raise best and reach the cutoff */
+	static bool _wratio_worth ( double bound , double best , double score_cutoff )
+	{
+		return bound > best && bound >= score_cutoff;
+	}
+
+	/* What a sub-score must reach to matter once multiplied by scale. It is
+	*   lowered a little so that rounding in the division never prunes a tie.
+	*/
+	static double _wratio_cutoff ( double best , double score_cutoff , double scale )
+	{
+		return std::max ( 0.0 , std::max ( best , score_cutoff ) / scale - 1e-7 );
+	}
+
+	//-------------------------------------------------------------------------
+
+	/* The sub-scores share their preprocessing: both strings are tokenized
+	*   and sorted once, which gives the token sort strings and the token set
+	*   of s1, and ratio and partial_ratio use the same masks of the shorter
+	*   string.
+	*
+	*   They are taken cheapest first. Each one is skipped when its largest
+	*   scaled value cannot beat the best so far, and otherwise gets the best
+	*   so far divided by its scale as its cutoff, so most pairs stop after
+	*   one or two.
+	*/
+	template <typename CharT>
+	double _wratio ( const std::basic_string<CharT>& s1 , const std::basic_string<CharT>& s2 , double score_cutoff )
+	{
+		typedef std::basic_string_view<CharT> View;
+
+		static thread_local std::vector<View>           tokens1 , tokens2;
+		static thread_local std::basic_string<CharT>    sorted1 , sorted2;
+		static thread_local BasicTokenDictionary<CharT> set1;
+		static thread_local BlockPatternMatchVector     PM;
+
+		// Validate string
+		if ( s1.length() == 0 || s2.length() == 0 )
+			return 0;
+
+		double unbase_scale  = WRATIO_UNBASE_SCALE;
+		double partial_scale;
+		bool   try_partial   = _wratio_partial ( s1.length() , s2.length() , partial_scale );
+
+		_token_views ( s1 , tokens1 );
+		_token_views ( s2 , tokens2 );
+
+		std::sort ( tokens1.begin() , tokens1.end() );
+		std::sort ( tokens2.begin() , tokens2.end() );
+
+		double best = 0;
+
 		if ( try_partial )
 		{
-			double partial = partial_ratio            ( s1 , s2 ) * partial_scale;
-			double ptsor   = partial_token_sort_ratio ( s1 , s2 ) * unbase_scale * partial_scale;
-			double ptser   = partial_token_set_ratio  ( s1 , s2 ) * unbase_scale * partial_scale;
-
-			return std::max (
-					 std::max ( base  , partial ) ,
-					 std::max ( ptsor , ptser   )
-			);
+			View shorter = s1 , longer = s2;
+
+			if ( shorter.length() > longer.length() )
+				std::swap ( shorter , longer );
+
+			PM.insert ( shorter.length() , shorter.data() );
+
+			// the length difference alone costs longer - shorter edits
+			size_t lensum = shorter.length() + longer.length();
+			double bound  = 100.0 * ( (double)(2 * shorter.length()) / (double)lensum );
+
+			if ( _wratio_worth ( bound , best , score_cutoff ) )
+				best = 100.0 * _ratio<CharT> ( PM , longer );
+
+			if ( _wratio_worth ( 100.0 * unbase_scale * partial_scale , best , score_cutoff ) )
+			{
+				double cutoff = _wratio_cutoff ( best , score_cutoff , unbase_scale * partial_scale );
+
+				_intern_tokens ( set1 , tokens1 );
+
+				best = std::max ( best , _token_set ( set1 , tokens2 , cutoff ) * unbase_scale * partial_scale );
+			}
+
+			if ( _wratio_worth ( 100.0 * partial_scale , best , score_cutoff ) )
+			{
+				double cutoff = _wratio_cutoff ( best , score_cutoff , partial_scale );
+
+				best = std::max ( best , _partial_ratio<CharT> ( shorter , longer , PM , cutoff ).score * partial_scale );
+			}
+
+			if ( _wratio_worth ( 100.0 * unbase_scale * partial_scale , best , score_cutoff ) )
+			{
+				double cutoff = _wratio_cutoff ( best , score_cutoff , unbase_scale * partial_scale );
+
+				_join_tokens ( tokens1 , sorted1 );
+				_join_tokens ( tokens2 , sorted2 );
+
+				best = std::max ( best , _partial_ratio_alignment<CharT> ( sorted1 , sorted2 , cutoff ).score * unbase_scale * partial_scale );
+			}
 		}
 		else
 		{
-			double tsor = token_sort_ratio ( s1 , s2 ) * unbase_scale;
-			double tser = token_set_ratio  ( s1 , s2 ) * unbase_scale;
+			if ( _wratio_worth ( 100.0 * unbase_scale , best , score_cutoff ) )
+			{
+				double cutoff = _wratio_cutoff ( best , score_cutoff , unbase_scale );
+
+				_join_tokens ( tokens1 , sorted1 );
+				_join_tokens ( tokens2 , sorted2 );
+
+				best = _ratio<CharT> ( sorted1 , sorted2 , cutoff ) * unbase_scale;
+			}
+
+			if ( _wratio_worth ( 100.0 * unbase_scale , best , score_cutoff ) )
+			{
+				double cutoff = _wratio_cutoff ( best , score_cutoff , unbase_scale );
+
+				_intern_tokens ( set1 , tokens1 );
 
-			return std::max ( tsor , tser );
+				best = std::max ( best , _token_set ( set1 , tokens2 , cutoff ) * unbase_scale );
+			}
 		}
+
+		return _cutoff ( best , score_cutoff );
 	}
-}
 
+	double WRatio ( const std::string& s1 , const std::string& s2 )
+	{
+		return _wratio ( s1 , s2 , 0 );
+	}
+
+	double WRatio ( const std::string& s1 , const std::string& s2 , double score_cutoff )
+	{
+		return _wratio ( s1 , s2 , score_cutoff );
+	}
+
+	//-------------------------------------------------------------------------
+
+	/* Bytes above 0x7f are kept as they are, code points are classified and
+	*   lower cased by Unicode.h
+	*/
+	template <typename CharT>
+	std::basic_string<CharT> _full_process ( const std::basic_string<CharT>& s )
+	{
+		std::basic_string<CharT> result ( s );
+
+		for ( auto it = result.begin(); it != result.end(); ++it )
+		{
+			if constexpr ( sizeof ( CharT ) == 1 )
+			{
+				unsigned char ch = (unsigned char) *it;
+
+				if ( ch < 0x80 && !isalnum ( ch ) && ch != '_' )
+					*it = ' ';
+				else if ( ch < 0x80 )
+					*it = (char) tolower ( ch );
+			}
+			else
+			{
+				uint32_t ch = (uint32_t) *it;
+
+				*it = unicode_is_word ( ch ) ? (CharT) unicode_to_lower ( ch ) : CharT(' ');
+			}
+		}
+
+		trim ( result );
+
+		return result;
+	}
+
+	std::string full_process ( const std::string& s )
+	{
+		return _full_process ( s );
+	}
+
+	//-------------------------------------------------------------------------
+	//-------------------------------------------------------------------------
+	//-------------------------------------------------------------------------
+
+	template <typename CharT>
+	BasicTokenizedString<CharT>::BasicTokenizedString ( const String& s ) :
+		_str ( s )
+	{
+		static thread_local std::vector< std::basic_string_view<CharT> > views;
+
+		_token_views ( _str , views );
+
+		std::sort ( views.begin() , views.end() );
+
+		for ( auto it = views.begin(); it != views.end(); ++it )
+			_append_token ( _sorted , *it );
+
+		views.erase ( std::unique ( views.begin() , views.end() ) , views.end() );
+
+		_tokens.assign ( views.begin() , views.end() );
+	}
+
+	//-------------------------------------------------------------------------
+
+	/* the tokens of s as views, valid until the next call on the same thread */
+	template <typename CharT>
+	static const std::vector< std::basic_string_view<CharT> >& _token_views ( const BasicTokenizedString<CharT>& s )
+	{
+		static thread_local std::vector< std::basic_string_view<CharT> > views;
+
+		views.assign ( s.tokens().begin() , s.tokens().end() );
+
+		return views;
+	}
+
+	//-------------------------------------------------------------------------
+
+	template <typename CharT>
+	BasicCachedRatio<CharT>::BasicCachedRatio ( const String& s1 ) :
+		_s1 ( s1 )
+	{
+		_PM.insert ( s1.length() , s1.data() );
+	}
+
+	//-------------------------------------------------------------------------
+
+	template <typename CharT>
+	double BasicCachedRatio<CharT>::similarity ( const String& s2 , double score_cutoff ) const
+	{
+		size_t lensum = _s1.length() + s2.length();
+
+		if ( lensum == 0 )
+			return _cutoff ( 100.0 , score_cutoff );
+
+		// the length difference alone may already exceed the allowed distance
+		if ( score_cutoff > 0 )
+		{
+			size_t ldiff = _s1.length() > s2.length() ? _s1.length() - s2.length() : s2.length() - _s1.length();
+
+			if ( 100.0 * ( (double)(lensum - ldiff)/(double)lensum ) < score_cutoff )
+				return 0;
+		}
+
+		return _cutoff ( 100.0 * _ratio<CharT> ( _PM , s2 ) , score_cutoff );
+	}
+
+	template <typename CharT>
+	double BasicCachedRatio<CharT>::similarity ( const BasicTokenizedString<CharT>& s2 , double score_cutoff ) const
+	{
+		return similarity ( s2.str() , score_cutoff );
+	}
+
+	template <typename CharT>
+	void BasicCachedRatio<CharT>::similarity_many ( const String* choices , size_t count , double* scores , double score_cutoff ) const
+	{
+		const size_t BATCH = 256;
+
+		// the lanes of lev_edit_distance_many hold bytes
+		if constexpr ( sizeof ( CharT ) != 1 )
+		{
+			for ( size_t k = 0; k < count; ++k )
+				scores[k] = similarity ( choices[k] , score_cutoff );
+		}
+		else
+		{
+			const char* strings[BATCH];
+			size_t      lens   [BATCH];
+			size_t      dist   [BATCH];
+
+			for ( size_t begin = 0; begin < count; begin += BATCH )
+			{
+				size_t n = std::min ( BATCH , count - begin );
+
+				for ( size_t k = 0; k < n; ++k )
+				{
+					strings[k] = choices[begin + k].data();
+					lens[k]    = choices[begin + k].length();
+				}
+
+				lev_edit_distance_many ( _s1.length() , _s1.data() , n , strings , lens , 1 , dist );
+
+				for ( size_t k = 0; k < n; ++k )
+				{
+					size_t lensum = _s1.length() + lens[k];
+
+					scores[begin + k] = lensum == 0 ? _cutoff ( 100.0 , score_cutoff ) :
+										_cutoff ( 100.0 * ( (double)(lensum - dist[k])/(double)lensum ) , score_cutoff );
+				}
+			}
+		}
+	}
+
+	//-------------------------------------------------------------------------
+
+	template <typename CharT>
+	BasicCachedPartialRatio<CharT>::BasicCachedPartialRatio ( const String& s1 ) :
+		_s1 ( s1 )
+	{
+		_PM.insert ( s1.length() , s1.data() );
+	}
+
+	//-------------------------------------------------------------------------
+
+	template <typename CharT>
+	double BasicCachedPartialRatio<CharT>::similarity ( const String& s2 , double score_cutoff ) const
+	{
+		// the masks are only usable while s1 is the shorter string
+		return _s1.length() <= s2.length() ?
+			   _partial_ratio<CharT> ( _s1 , s2 , _PM , score_cutoff ).score :
+			   _partial_ratio<CharT> ( s2 , _s1 , score_cutoff ).score;
+	}
+
+	template <typename CharT>
+	double BasicCachedPartialRatio<CharT>::similarity ( const BasicTokenizedString<CharT>& s2 , double score_cutoff ) const
+	{
+		return similarity ( s2.str() , score_cutoff );
+	}
+
+	//-------------------------------------------------------------------------
+
+	template <typename CharT>
+	BasicCachedTokenSortRatio<CharT>::BasicCachedTokenSortRatio ( const String& s1 ) :
+		_sorted1 ( _sorted_tokens ( s1 ) ) ,
+		_ratio   ( _sorted1 )
+	{
+	}
+
+	//-------------------------------------------------------------------------
+
+	template <typename CharT>
+	double BasicCachedTokenSortRatio<CharT>::similarity ( const String& s2 , double score_cutoff ) const
+	{
+		static thread_local String sorted2;
+
+		_sorted_tokens ( s2 , sorted2 );
+
+		return _ratio.similarity ( sorted2 , score_cutoff );
+	}
+
+	template <typename CharT>
+	double BasicCachedTokenSortRatio<CharT>::similarity ( const BasicTokenizedString<CharT>& s2 , double score_cutoff ) const
+	{
+		return _ratio.similarity ( s2.sorted() , score_cutoff );
+	}
+
+	//-------------------------------------------------------------------------
+
+	template <typename CharT>
+	BasicCachedPartialTokenSortRatio<CharT>::BasicCachedPartialTokenSortRatio ( const String& s1 ) :
+		_sorted1       ( _sorted_tokens ( s1 ) ) ,
+		_partial_ratio ( _sorted1 )
+	{
+	}
+
+	//-------------------------------------------------------------------------
+
+	template <typename CharT>
+	double BasicCachedPartialTokenSortRatio<CharT>::similarity ( const String& s2 , double score_cutoff ) const
+	{
+		static thread_local String sorted2;
+
+		_sorted_tokens ( s2 , sorted2 );
+
+		return _partial_ratio.similarity ( sorted2 , score_cutoff );
+	}
+
+	template <typename CharT>
+	double BasicCachedPartialTokenSortRatio<CharT>::similarity ( const BasicTokenizedString<CharT>& s2 , double score_cutoff ) const
+	{
+		return _partial_ratio.similarity ( s2.sorted() , score_cutoff );
+	}
+
+	//-------------------------------------------------------------------------
+
+	template <typename CharT>
+	BasicCachedTokenSetRatio<CharT>::BasicCachedTokenSetRatio ( const String& s1 )
+	{
+		_intern_token_set ( _tokens1 , s1 );
+	}
+
+	//-------------------------------------------------------------------------
+
+	template <typename CharT>
+	double BasicCachedTokenSetRatio<CharT>::similarity ( const String& s2 , double score_cutoff ) const
+	{
+		static thread_local std::vector< std::basic_string_view<CharT> > tokens2;
+
+		_token_views ( s2 , tokens2 );
+
+		return _cutoff ( _token_set ( _tokens1 , tokens2 , score_cutoff ) , score_cutoff );
+	}
+
+	template <typename CharT>
+	double BasicCachedTokenSetRatio<CharT>::similarity ( const BasicTokenizedString<CharT>& s2 , double score_cutoff ) const
+	{
+		return _cutoff ( _token_set ( _tokens1 , _token_views ( s2 ) , score_cutoff ) , score_cutoff );
+	}
+
+	//-------------------------------------------------------------------------
+
+	template <typename CharT>
+	BasicCachedPartialTokenSetRatio<CharT>::BasicCachedPartialTokenSetRatio ( const String& s1 )
+	{
+		_intern_token_set ( _tokens1 , s1 );
+	}
+
+	//-------------------------------------------------------------------------
+
+	template <typename CharT>
+	double BasicCachedPartialTokenSetRatio<CharT>::similarity ( const String& s2 , double score_cutoff ) const
+	{
+		static thread_local std::vector< std::basic_string_view<CharT> > tokens2;
+
+		_token_views ( s2 , tokens2 );
+
+		return _cutoff ( _token_set ( _tokens1 , tokens2 , score_cutoff ) , score_cutoff );
+	}
+
+	template <typename CharT>
+	double BasicCachedPartialTokenSetRatio<CharT>::similarity ( const BasicTokenizedString<CharT>& s2 , double score_cutoff ) const
+	{
+		return _cutoff ( _token_set ( _tokens1 , _token_views ( s2 ) , score_cutoff ) , score_cutoff );
+	}
+
+	//-------------------------------------------------------------------------
+
+	template <typename CharT>
+	BasicCachedWRatio<CharT>::BasicCachedWRatio ( const String& s1 ) :
+		_s1                       ( s1 ) ,
+		_ratio                    ( s1 ) ,
+		_partial_ratio            ( s1 ) ,
+		_sorted1                  ( _sorted_tokens ( s1 ) ) ,
+		_token_sort_ratio         ( _sorted1 ) ,
+		_partial_token_sort_ratio ( _sorted1 )
+	{
+		_intern_token_set ( _tokens1 , s1 );
+	}
+
+	//-------------------------------------------------------------------------
+
+	template <typename CharT>
+	double BasicCachedWRatio<CharT>::similarity ( const String& s2 , double score_cutoff ) const
+	{
+		static thread_local std::vector< std::basic_string_view<CharT> > tokens2;
+		static thread_local String                        sorted2;
+
+		// Validate string
+		if ( _s1.length() == 0 || s2.length() == 0 )
+			return 0;
+
+		_token_views ( s2 , tokens2 );
+
+		std::sort ( tokens2.begin() , tokens2.end() );
+
+		_join_tokens ( tokens2 , sorted2 );
+
+		return _similarity ( s2 , sorted2 , tokens2 , score_cutoff );
+	}
+
+	template <typename CharT>
+	double BasicCachedWRatio<CharT>::similarity ( const BasicTokenizedString<CharT>& s2 , double score_cutoff ) const
+	{
+		// Validate string
+		if ( _s1.length() == 0 || s2.str().length() == 0 )
+			return 0;
+
+		return _similarity ( s2.str() , s2.sorted() , _token_views ( s2 ) , score_cutoff );
+	}
+
+	/* in the same order and with the same pruning as _wratio */
+	template <typename CharT>
+	double BasicCachedWRatio<CharT>::_similarity ( const String& s2 , const String& sorted2 ,
+									   const std::vector<View>& tokens2 , double score_cutoff ) const
+	{
+		double unbase_scale  = WRATIO_UNBASE_SCALE;
+		double partial_scale;
+		bool   try_partial   = _wratio_partial ( _s1.length() , s2.length() , partial_scale );
+
+		double best = 0;
+
+		if ( try_partial )
+		{
+			if ( _wratio_worth ( 100.0 , best , score_cutoff ) )
+				best = _ratio.similarity ( s2 , score_cutoff );
+
+			if ( _wratio_worth ( 100.0 * unbase_scale * partial_scale , best , score_cutoff ) )
+			{
+				double cutoff = _wratio_cutoff ( best , score_cutoff , unbase_scale * partial_scale );
+
+				best = std::max ( best , _token_set ( _tokens1 , tokens2 , cutoff ) * unbase_scale * partial_scale );
+			}
+
+			if ( _wratio_worth ( 100.0 * partial_scale , best , score_cutoff ) )
+			{
+				double cutoff = _wratio_cutoff ( best , score_cutoff , partial_scale );
+
+				best = std::max ( best , _partial_ratio.similarity ( s2 , cutoff ) * partial_scale );
+			}
+
+			if ( _wratio_worth ( 100.0 * unbase_scale * partial_scale , best , score_cutoff ) )
+			{
+				double cutoff = _wratio_cutoff ( best , score_cutoff , unbase_scale * partial_scale );
+
+				best = std::max ( best , _partial_token_sort_ratio.similarity ( sorted2 , cutoff ) * unbase_scale * partial_scale );
+			}
+		}
+		else
+		{
+			if ( _wratio_worth ( 100.0 * unbase_scale , best , score_cutoff ) )
+			{
+				double cutoff = _wratio_cutoff ( best , score_cutoff , unbase_scale );
+
+				best = _token_sort_ratio.similarity ( sorted2 , cutoff ) * unbase_scale;
+			}
+
+			if ( _wratio_worth ( 100.0 * unbase_scale , best , score_cutoff ) )
+			{
+				double cutoff = _wratio_cutoff ( best , score_cutoff , unbase_scale );
+
+				best = std::max ( best , _token_set ( _tokens1 , tokens2 , cutoff ) * unbase_scale );
+			}
+		}
+
+		return _cutoff ( best , score_cutoff );
+	}
+
+	//-------------------------------------------------------------------------
+
+	template class BasicTokenizedString<char>;
+	template class BasicCachedRatio<char>;
+	template class BasicCachedPartialRatio<char>;
+	template class BasicCachedTokenSortRatio<char>;
+	template class BasicCachedPartialTokenSortRatio<char>;
+	template class BasicCachedTokenSetRatio<char>;
+	template class BasicCachedPartialTokenSetRatio<char>;
+	template class BasicCachedWRatio<char>;
+
+	template class BasicTokenizedString<char16_t>;
+	template class BasicCachedRatio<char16_t>;
+	template class BasicCachedPartialRatio<char16_t>;
+	template class BasicCachedTokenSortRatio<char16_t>;
+	template class BasicCachedPartialTokenSortRatio<char16_t>;
+	template class BasicCachedTokenSetRatio<char16_t>;
+	template class BasicCachedPartialTokenSetRatio<char16_t>;
+	template class BasicCachedWRatio<char16_t>;
+
+	template class BasicTokenizedString<char32_t>;
+	template class BasicCachedRatio<char32_t>;
+	template class BasicCachedPartialRatio<char32_t>;
+	template class BasicCachedTokenSortRatio<char32_t>;
+	template class BasicCachedPartialTokenSortRatio<char32_t>;
+	template class BasicCachedTokenSetRatio<char32_t>;
+	template class BasicCachedPartialTokenSetRatio<char32_t>;
+	template class BasicCachedWRatio<char32_t>;
+
+	//-------------------------------------------------------------------------
+	//-------------------------------------------------------------------------
+	//-------------------------------------------------------------------------
+
+	double ratio ( const std::u16string& s1 , const std::u16string& s2 )
+	{
+		U16SequenceMatcherView m ( s1 , s2 );
+		return  100.0 * m.ratio();
+	}
+
+	double ratio ( const std::u16string& s1 , const std::u16string& s2 , double score_cutoff )
+	{
+		U16SequenceMatcherView m ( s1 , s2 );
+		return _matcher_ratio ( m , score_cutoff );
+	}
+
+	double partial_ratio ( const std::u16string& s1 , const std::u16string& s2 )
+	{
+		return partial_ratio_alignment ( s1 , s2 ).score;
+	}
+
+	double partial_ratio ( const std::u16string& s1 , const std::u16string& s2 , double score_cutoff )
+	{
+		return partial_ratio_alignment ( s1 , s2 , score_cutoff ).score;
+	}
+
+	ScoreAlignment partial_ratio_alignment ( const std::u16string& s1 , const std::u16string& s2 , double score_cutoff )
+	{
+		return _partial_ratio_alignment<char16_t> ( s1 , s2 , score_cutoff );
+	}
+
+	double token_sort_ratio ( const std::u16string& s1 , const std::u16string& s2 )
+	{
+		return _token_sort ( s1 , s2 , false );
+	}
+
+	double partial_token_sort_ratio ( const std::u16string& s1 , const std::u16string& s2 )
+	{
+		return _token_sort ( s1 , s2 , true );
+	}
+
+	double token_set_ratio ( const std::u16string& s1 , const std::u16string& s2 )
+	{
+		return _token_set ( s1 , s2 );
+	}
+
+	double partial_token_set_ratio ( const std::u16string& s1 , const std::u16string& s2 )
+	{
+		return _token_set ( s1 , s2 );
+	}
+
+	double WRatio ( const std::u16string& s1 , const std::u16string& s2 )
+	{
+		return _wratio ( s1 , s2 , 0 );
+	}
+
+	double WRatio ( const std::u16string& s1 , const std::u16string& s2 , double score_cutoff )
+	{
+		return _wratio ( s1 , s2 , score_cutoff );
+	}
+
+	std::u16string full_process ( const std::u16string& s )
+	{
+		return _full_process ( s );
+	}
+
+	//-------------------------------------------------------------------------
+
+	double ratio ( const std::u32string& s1 , const std::u32string& s2 )
+	{
+		U32SequenceMatcherView m ( s1 , s2 );
+		return  100.0 * m.ratio();
+	}
+
+	double ratio ( const std::u32string& s1 , const std::u32string& s2 , double score_cutoff )
+	{
+		U32SequenceMatcherView m ( s1 , s2 );
+		return _matcher_ratio ( m , score_cutoff );
+	}
+
+	double partial_ratio ( const std::u32string& s1 , const std::u32string& s2 )
+	{
+		return partial_ratio_alignment ( s1 , s2 ).score;
+	}
+
+	double partial_ratio ( const std::u32string& s1 , const std::u32string& s2 , double score_cutoff )
+	{
+		return partial_ratio_alignment ( s1 , s2 , score_cutoff ).score;
+	}
+
+	ScoreAlignment partial_ratio_alignment ( const std::u32string& s1 , const std::u32string& s2 , double score_cutoff )
+	{
+		return _partial_ratio_alignment<char32_t> ( s1 , s2 , score_cutoff );
+	}
+
+	double token_sort_ratio ( const std::u32string& s1 , const std::u32string& s2 )
+	{
+		return _token_sort ( s1 , s2 , false );
+	}
+
+	double partial_token_sort_ratio ( const std::u32string& s1 , const std::u32string& s2 )
+	{
+		return _token_sort ( s1 , s2 , true );
+	}
+
+	double token_set_ratio ( const std::u32string& s1 , const std::u32string& s2 )
+	{
+		return _token_set ( s1 , s2 );
+	}
+
+	double partial_token_set_ratio ( const std::u32string& s1 , const std::u32string& s2 )
+	{
+		return _token_set ( s1 , s2 );
+	}
+
+	double WRatio ( const std::u32string& s1 , const std::u32string& s2 )
+	{
+		return _wratio ( s1 , s2 , 0 );
+	}
+
+	double WRatio ( const std::u32string& s1 , const std::u32string& s2 , double score_cutoff )
+	{
+		return _wratio ( s1 , s2 , score_cutoff );
+	}
+
+	std::u32string full_process ( const std::u32string& s )
+	{
+		return _full_process ( s );
+	}
+
+	//-------------------------------------------------------------------------
+	//-------------------------------------------------------------------------
+	//-------------------------------------------------------------------------
+
+namespace utf8
+{
+	double ratio ( const std::string& s1 , const std::string& s2 )
+	{
+		return FuzzyWuzzy::ratio ( utf8_decode ( s1 ) , utf8_decode ( s2 ) );
+	}
+
+	double ratio ( const std::string& s1 , const std::string& s2 , double score_cutoff )
+	{
+		return FuzzyWuzzy::ratio ( utf8_decode ( s1 ) , utf8_decode ( s2 ) , score_cutoff );
+	}
+
+	double partial_ratio ( const std::string& s1 , const std::string& s2 )
+	{
+		return FuzzyWuzzy::partial_ratio ( utf8_decode ( s1 ) , utf8_decode ( s2 ) );
+	}
+
+	double partial_ratio ( const std::string& s1 , const std::string& s2 , double score_cutoff )
+	{
+		return FuzzyWuzzy::partial_ratio ( utf8_decode ( s1 ) , utf8_decode ( s2 ) , score_cutoff );
+	}
+
+	double token_sort_ratio ( const std::string& s1 , const std::string& s2 )
+	{
+		return FuzzyWuzzy::token_sort_ratio ( utf8_decode ( s1 ) , utf8_decode ( s2 ) );
+	}
+
+	double partial_token_sort_ratio ( const std::string& s1 , const std::string& s2 )
+	{
+		return FuzzyWuzzy::partial_token_sort_ratio ( utf8_decode ( s1 ) , utf8_decode ( s2 ) );
+	}
+
+	double token_set_ratio ( const std::string& s1 , const std::string& s2 )
+	{
+		return FuzzyWuzzy::token_set_ratio ( utf8_decode ( s1 ) , utf8_decode ( s2 ) );
+	}
+
+	double partial_token_set_ratio ( const std::string& s1 , const std::string& s2 )
+	{
+		return FuzzyWuzzy::partial_token_set_ratio ( utf8_decode ( s1 ) , utf8_decode ( s2 ) );
+	}
+
+	double WRatio ( const std::string& s1 , const std::string& s2 )
+	{
+		return FuzzyWuzzy::WRatio ( utf8_decode ( s1 ) , utf8_decode ( s2 ) );
+	}
+
+	double WRatio ( const std::string& s1 , const std::string& s2 , double score_cutoff )
+	{
+		return FuzzyWuzzy::WRatio ( utf8_decode ( s1 ) , utf8_decode ( s2 ) , score_cutoff );
+	}
+
+	std::string full_process ( const std::string& s )
+	{
+		return utf8_encode ( FuzzyWuzzy::full_process ( utf8_decode ( s ) ) );
+	}
+}
+}
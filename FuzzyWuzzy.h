@@ -5,7 +5,11 @@
 #ifndef FuzzyWuzzyH
 #define FuzzyWuzzyH
 
+#include "Levenshtein.h"
+#include "Tokenizer.h"
+#include "Unicode.h"
 #include <string>
+#include <vector>
 
 namespace FuzzyWuzzy
 {
@@ -13,8 +17,25 @@ namespace FuzzyWuzzy
 	//# Basic Scoring Functions #
 	//###########################
 
+	// Overloads taking a score_cutoff (0..100) return 0 when the score is
+	// below the cutoff and may stop computing as soon as that is certain.
+
 	double ratio                    ( const std::string& s1 , const std::string& s2 );
+	double ratio                    ( const std::string& s1 , const std::string& s2 , double score_cutoff );
 	double partial_ratio            ( const std::string& s1 , const std::string& s2 );
+	double partial_ratio            ( const std::string& s1 , const std::string& s2 , double score_cutoff );
+
+	// Where partial_ratio found its best score: the shorter string is aligned
+	// as a whole, the other range is the window of the longer one. Windows
+	// may stick out of either end of the longer string.
+	struct ScoreAlignment
+	{
+		double score;
+		size_t src_start  , src_end;   // range of s1
+		size_t dest_start , dest_end;  // range of s2
+	};
+
+	ScoreAlignment partial_ratio_alignment ( const std::string& s1 , const std::string& s2 , double score_cutoff = 0 );
 
 	//##############################
 	//# Advanced Scoring Functions #
@@ -31,6 +52,383 @@ namespace FuzzyWuzzy
 
 	// w is for weighted
 	double WRatio ( const std::string& s1 , const std::string& s2 );
+	double WRatio ( const std::string& s1 , const std::string& s2 , double score_cutoff );
+
+	//#########
+	//# Utils #
+	//#########
+
+	// replaces everything but letters, digits and '_' with whitespace,
+	// lower cases and trims (bytes above 0x7f are kept as they are)
+	std::string full_process ( const std::string& s );
+
+	//######################
+	//# UTF-16 and UTF-32 #
+	//######################
+
+	// The functions above on UTF-16 code units and on code points, e.g. from
+	// utf8_decode in Unicode.h: a character is one edit whatever its value,
+	// tokens are the runs of unicode_is_word and full_process lower cases
+	// with unicode_to_lower. On ASCII they score the same as the byte versions.
+
+	double ratio                    ( const std::u16string& s1 , const std::u16string& s2 );
+	double ratio                    ( const std::u16string& s1 , const std::u16string& s2 , double score_cutoff );
+	double partial_ratio            ( const std::u16string& s1 , const std::u16string& s2 );
+	double partial_ratio            ( const std::u16string& s1 , const std::u16string& s2 , double score_cutoff );
+	ScoreAlignment partial_ratio_alignment ( const std::u16string& s1 , const std::u16string& s2 , double score_cutoff = 0 );
+	double token_sort_ratio         ( const std::u16string& s1 , const std::u16string& s2 );
+	double partial_token_sort_ratio ( const std::u16string& s1 , const std::u16string& s2 );
+	double token_set_ratio          ( const std::u16string& s1 , const std::u16string& s2 );
+	double partial_token_set_ratio  ( const std::u16string& s1 , const std::u16string& s2 );
+	double WRatio                   ( const std::u16string& s1 , const std::u16string& s2 );
+	double WRatio                   ( const std::u16string& s1 , const std::u16string& s2 , double score_cutoff );
+	std::u16string full_process     ( const std::u16string& s );
+
+	double ratio                    ( const std::u32string& s1 , const std::u32string& s2 );
+	double ratio                    ( const std::u32string& s1 , const std::u32string& s2 , double score_cutoff );
+	double partial_ratio            ( const std::u32string& s1 , const std::u32string& s2 );
+	double partial_ratio            ( const std::u32string& s1 , const std::u32string& s2 , double score_cutoff );
+	ScoreAlignment partial_ratio_alignment ( const std::u32string& s1 , const std::u32string& s2 , double score_cutoff = 0 );
+	double token_sort_ratio         ( const std::u32string& s1 , const std::u32string& s2 );
+	double partial_token_sort_ratio ( const std::u32string& s1 , const std::u32string& s2 );
+	double token_set_ratio          ( const std::u32string& s1 , const std::u32string& s2 );
+	double partial_token_set_ratio  ( const std::u32string& s1 , const std::u32string& s2 );
+	double WRatio                   ( const std::u32string& s1 , const std::u32string& s2 );
+	double WRatio                   ( const std::u32string& s1 , const std::u32string& s2 , double score_cutoff );
+	std::u32string full_process     ( const std::u32string& s );
+
+	//##################
+	//# Cached Scorers #
+	//##################
+
+	// Preprocessed queries for one-vs-many scoring: everything that only
+	// depends on s1 is computed once by the constructor. similarity ( s2 )
+	// returns the same score as the function above called with ( s1 , s2 ),
+	// or 0 when it is below score_cutoff.
+	//
+	// For many-vs-many scoring the choices can be tokenized once as well and
+	// passed as TokenizedString.
+	//
+	// The Basic templates take the character type of the functions above:
+	// CachedRatio scores bytes, U16CachedRatio UTF-16 code units and
+	// U32CachedRatio code points, and so on.
+
+	template <typename CharT>
+	class BasicTokenizedString
+	{
+	public:
+
+		typedef std::basic_string<CharT> String;
+
+	private :
+
+		String              _str;
+		String              _sorted;
+		std::vector<String> _tokens;
+
+	public:
+
+		BasicTokenizedString ( const String& s );
+
+		// the string as given
+		const String&              str    ( void ) const { return _str;    }
+		// its tokens sorted and joined by spaces
+		const String&              sorted ( void ) const { return _sorted; }
+		// its distinct tokens, sorted
+		const std::vector<String>& tokens ( void ) const { return _tokens; }
+	};
+
+	//---------------------------------------------------------------------------
+
+	template <typename CharT>
+	class BasicCachedRatio
+	{
+	public:
+
+		typedef std::basic_string<CharT> String;
+
+	private :
+
+		String                  _s1;
+		BlockPatternMatchVector _PM;
+
+	public:
+
+		BasicCachedRatio ( const String& s1 );
+
+		double similarity ( const String&                      s2 , double score_cutoff = 0 ) const;
+		double similarity ( const BasicTokenizedString<CharT>& s2 , double score_cutoff = 0 ) const;
+
+		// similarity of every one of choices[0 .. count) into scores, short
+		// byte strings are scored many at once (see lev_edit_distance_many)
+		void similarity_many ( const String* choices , size_t count , double* scores , double score_cutoff = 0 ) const;
+	};
+
+	//---------------------------------------------------------------------------
+
+	template <typename CharT>
+	class BasicCachedPartialRatio
+	{
+	public:
+
+		typedef std::basic_string<CharT> String;
+
+	private :
+
+		String                  _s1;
+		BlockPatternMatchVector _PM;
+
+	public:
+
+		BasicCachedPartialRatio ( const String& s1 );
+
+		double similarity ( const String&                      s2 , double score_cutoff = 0 ) const;
+		double similarity ( const BasicTokenizedString<CharT>& s2 , double score_cutoff = 0 ) const;
+	};
+
+	//---------------------------------------------------------------------------
+
+	template <typename CharT>
+	class BasicCachedTokenSortRatio
+	{
+	public:
+
+		typedef std::basic_string<CharT> String;
+
+	private :
+
+		String                  _sorted1;
+		BasicCachedRatio<CharT> _ratio;
+
+	public:
+
+		BasicCachedTokenSortRatio ( const String& s1 );
+
+		double similarity ( const String&                      s2 , double score_cutoff = 0 ) const;
+		double similarity ( const BasicTokenizedString<CharT>& s2 , double score_cutoff = 0 ) const;
+	};
+
+	//---------------------------------------------------------------------------
+
+	template <typename CharT>
+	class BasicCachedPartialTokenSortRatio
+	{
+	public:
+
+		typedef std::basic_string<CharT> String;
+
+	private :
+
+		String                         _sorted1;
+		BasicCachedPartialRatio<CharT> _partial_ratio;
+
+	public:
+
+		BasicCachedPartialTokenSortRatio ( const String& s1 );
+
+		double similarity ( const String&                      s2 , double score_cutoff = 0 ) const;
+		double similarity ( const BasicTokenizedString<CharT>& s2 , double score_cutoff = 0 ) const;
+	};
+
+	//---------------------------------------------------------------------------
+
+	template <typename CharT>
+	class BasicCachedTokenSetRatio
+	{
+	public:
+
+		typedef std::basic_string<CharT> String;
+
+	private :
+
+		BasicTokenDictionary<CharT> _tokens1;   // the token set of s1, ids in sorted order
+
+	public:
+
+		BasicCachedTokenSetRatio ( const String& s1 );
+
+		double similarity ( const String&                      s2 , double score_cutoff = 0 ) const;
+		double similarity ( const BasicTokenizedString<CharT>& s2 , double score_cutoff = 0 ) const;
+	};
+
+	//---------------------------------------------------------------------------
+
+	template <typename CharT>
+	class BasicCachedPartialTokenSetRatio
+	{
+	public:
+
+		typedef std::basic_string<CharT> String;
+
+	private :
+
+		BasicTokenDictionary<CharT> _tokens1;
+
+	public:
+
+		BasicCachedPartialTokenSetRatio ( const String& s1 );
+
+		double similarity ( const String&                      s2 , double score_cutoff = 0 ) const;
+		double similarity ( const BasicTokenizedString<CharT>& s2 , double score_cutoff = 0 ) const;
+	};
+
+	//---------------------------------------------------------------------------
+
+	template <typename CharT>
+	class BasicCachedWRatio
+	{
+	public:
+
+		typedef std::basic_string<CharT> String;
+
+	private :
+
+		typedef std::basic_string_view<CharT> View;
+
+		String                         _s1;
+		BasicCachedRatio<CharT>        _ratio;
+		BasicCachedPartialRatio<CharT> _partial_ratio;
+		String                         _sorted1;
+		BasicCachedRatio<CharT>        _token_sort_ratio;
+		BasicCachedPartialRatio<CharT> _partial_token_sort_ratio;
+		BasicTokenDictionary<CharT>    _tokens1;
+
+		double _similarity ( const String& s2 , const String& sorted2 ,
+							 const std::vector<View>& tokens2 , double score_cutoff ) const;
+
+	public:
+
+		BasicCachedWRatio ( const String& s1 );
+
+		double similarity ( const String&                      s2 , double score_cutoff = 0 ) const;
+		double similarity ( const BasicTokenizedString<CharT>& s2 , double score_cutoff = 0 ) const;
+	};
+
+	//---------------------------------------------------------------------------
+
+	typedef BasicTokenizedString<char>                  TokenizedString;
+	typedef BasicCachedRatio<char>                      CachedRatio;
+	typedef BasicCachedPartialRatio<char>               CachedPartialRatio;
+	typedef BasicCachedTokenSortRatio<char>             CachedTokenSortRatio;
+	typedef BasicCachedPartialTokenSortRatio<char>      CachedPartialTokenSortRatio;
+	typedef BasicCachedTokenSetRatio<char>              CachedTokenSetRatio;
+	typedef BasicCachedPartialTokenSetRatio<char>       CachedPartialTokenSetRatio;
+	typedef BasicCachedWRatio<char>                     CachedWRatio;
+
+	typedef BasicTokenizedString<char16_t>              U16TokenizedString;
+	typedef BasicCachedRatio<char16_t>                  U16CachedRatio;
+	typedef BasicCachedPartialRatio<char16_t>           U16CachedPartialRatio;
+	typedef BasicCachedTokenSortRatio<char16_t>         U16CachedTokenSortRatio;
+	typedef BasicCachedPartialTokenSortRatio<char16_t>  U16CachedPartialTokenSortRatio;
+	typedef BasicCachedTokenSetRatio<char16_t>          U16CachedTokenSetRatio;
+	typedef BasicCachedPartialTokenSetRatio<char16_t>   U16CachedPartialTokenSetRatio;
+	typedef BasicCachedWRatio<char16_t>                 U16CachedWRatio;
+
+	typedef BasicTokenizedString<char32_t>              U32TokenizedString;
+	typedef BasicCachedRatio<char32_t>                  U32CachedRatio;
+	typedef BasicCachedPartialRatio<char32_t>           U32CachedPartialRatio;
+	typedef BasicCachedTokenSortRatio<char32_t>         U32CachedTokenSortRatio;
+	typedef BasicCachedPartialTokenSortRatio<char32_t>  U32CachedPartialTokenSortRatio;
+	typedef BasicCachedTokenSetRatio<char32_t>          U32CachedTokenSetRatio;
+	typedef BasicCachedPartialTokenSetRatio<char32_t>   U32CachedPartialTokenSetRatio;
+	typedef BasicCachedWRatio<char32_t>                 U32CachedWRatio;
+
+	extern template class BasicTokenizedString<char>;
+	extern template class BasicCachedRatio<char>;
+	extern template class BasicCachedPartialRatio<char>;
+	extern template class BasicCachedTokenSortRatio<char>;
+	extern template class BasicCachedPartialTokenSortRatio<char>;
+	extern template class BasicCachedTokenSetRatio<char>;
+	extern template class BasicCachedPartialTokenSetRatio<char>;
+	extern template class BasicCachedWRatio<char>;
+
+	extern template class BasicTokenizedString<char16_t>;
+	extern template class BasicCachedRatio<char16_t>;
+	extern template class BasicCachedPartialRatio<char16_t>;
+	extern template class BasicCachedTokenSortRatio<char16_t>;
+	extern template class BasicCachedPartialTokenSortRatio<char16_t>;
+	extern template class BasicCachedTokenSetRatio<char16_t>;
+	extern template class BasicCachedPartialTokenSetRatio<char16_t>;
+	extern template class BasicCachedWRatio<char16_t>;
+
+	extern template class BasicTokenizedString<char32_t>;
+	extern template class BasicCachedRatio<char32_t>;
+	extern template class BasicCachedPartialRatio<char32_t>;
+	extern template class BasicCachedTokenSortRatio<char32_t>;
+	extern template class BasicCachedPartialTokenSortRatio<char32_t>;
+	extern template class BasicCachedTokenSetRatio<char32_t>;
+	extern template class BasicCachedPartialTokenSetRatio<char32_t>;
+	extern template class BasicCachedWRatio<char32_t>;
+
+	//#########
+	//# UTF-8 #
+	//#########
+
+	// The code point functions on UTF-8 strings: both sides go through
+	// utf8_decode, scores are those of the std::u32string versions and
+	// full_process returns UTF-8 again.
+
+namespace utf8
+{
+	double ratio                    ( const std::string& s1 , const std::string& s2 );
+	double ratio                    ( const std::string& s1 , const std::string& s2 , double score_cutoff );
+	double partial_ratio            ( const std::string& s1 , const std::string& s2 );
+	double partial_ratio            ( const std::string& s1 , const std::string& s2 , double score_cutoff );
+	double token_sort_ratio         ( const std::string& s1 , const std::string& s2 );
+	double partial_token_sort_ratio ( const std::string& s1 , const std::string& s2 );
+	double token_set_ratio          ( const std::string& s1 , const std::string& s2 );
+	double partial_token_set_ratio  ( const std::string& s1 , const std::string& s2 );
+	double WRatio                   ( const std::string& s1 , const std::string& s2 );
+	double WRatio                   ( const std::string& s1 , const std::string& s2 , double score_cutoff );
+	std::string full_process        ( const std::string& s );
+
+	//---------------------------------------------------------------------------
+
+	// A code point cached scorer (U32CachedRatio...) taking UTF-8: s1 is
+	// decoded once, every s2 into a buffer of the thread. Choices scored many
+	// times can be decoded and tokenized once as U32TokenizedString.
+
+	template <typename U32CachedScorer>
+	class BasicCached
+	{
+	private :
+
+		U32CachedScorer _cached;
+
+	public:
+
+		typedef std::string String;
+
+		BasicCached ( const std::string& s1 ) : _cached ( utf8_decode ( s1 ) ) {}
+
+		double similarity ( const std::string& s2 , double score_cutoff = 0 ) const
+		{
+			static thread_local std::u32string decoded;
+
+			utf8_decode ( s2.data() , s2.length() , decoded );
+
+			return _cached.similarity ( decoded , score_cutoff );
+		}
+
+		double similarity ( const std::u32string& s2 , double score_cutoff = 0 ) const
+		{
+			return _cached.similarity ( s2 , score_cutoff );
+		}
+
+		double similarity ( const U32TokenizedString& s2 , double score_cutoff = 0 ) const
+		{
+			return _cached.similarity ( s2 , score_cutoff );
+		}
+	};
+
+	typedef BasicCached<U32CachedRatio>                  CachedRatio;
+	typedef BasicCached<U32CachedPartialRatio>           CachedPartialRatio;
+	typedef BasicCached<U32CachedTokenSortRatio>         CachedTokenSortRatio;
+	typedef BasicCached<U32CachedPartialTokenSortRatio>  CachedPartialTokenSortRatio;
+	typedef BasicCached<U32CachedTokenSetRatio>          CachedTokenSetRatio;
+	typedef BasicCached<U32CachedPartialTokenSetRatio>   CachedPartialTokenSetRatio;
+	typedef BasicCached<U32CachedWRatio>                 CachedWRatio;
+}
 }
 
 #endif
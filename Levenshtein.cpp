@@ -1,13 +1,881 @@
 //@see https://github.com/miohtama/python-Levenshtein
 //
+// The bit-parallel kernels follow
+//   G. Myers, "A fast bit-vector algorithm for approximate string matching
+//   based on dynamic programming", 1999
+//   H. Hyyro, "A bit-vector algorithm for computing Levenshtein and Damerau
+//   edit distances", 2003
+//   H. Hyyro, "Bit-parallel LCS-length computation revisited", 2004
+//
 #include "Levenshtein.h"
+#include <string>
+
+#if defined(__GNUC__) && ( defined(__x86_64__) || defined(__i386__) )
+#define FUZZYWUZZY_X86 1
+#endif
 
 namespace FuzzyWuzzy
 {
 
+	//---------------------------------------------------------------------------
+	// Pattern match vectors
+	//---------------------------------------------------------------------------
+
+	PatternMatchVector::PatternMatchVector ( void )
+	{
+	  memset(_map, 0, sizeof(_map));
+	  _len = 0;
+	}
+
+	PatternMatchVector::PatternMatchVector ( size_t len , const char* str )
+	{
+	  insert(len, str);
+	}
+
+	void PatternMatchVector::insert ( size_t len , const char* str )
+	{
+	  size_t i;
+	  uint64_t mask = 1;
+
+	  memset(_map, 0, sizeof(_map));
+	  _len = len;
+	  for (i = 0; i < len; i++, mask <<= 1)
+		_map[(unsigned char)str[i]] |= mask;
+	}
+
+	//---------------------------------------------------------------------------
+
+	BlockPatternMatchVector::BlockPatternMatchVector ( void )
+	{
+	  _len = 0;
+	  _block_count = 0;
+	}
+
+	BlockPatternMatchVector::BlockPatternMatchVector ( size_t len , const char* str )
+	{
+	  insert(len, str);
+	}
+
+	void BlockPatternMatchVector::insert ( size_t len , const char* str )
+	{
+	  size_t i;
+
+	  _len = len;
+	  _block_count = (len + 63) / 64;
+	  _map.assign(256 * _block_count, 0);
+	  _wide_keys.clear();
+	  for (i = 0; i < len; i++)
+		_map[(unsigned char)str[i] * _block_count + i / 64] |= (uint64_t)1 << (i % 64);
+	}
+
+	void BlockPatternMatchVector::insert ( size_t len , const char16_t* str )
+	{
+	  _insert(len, str);
+	}
+
+	void BlockPatternMatchVector::insert ( size_t len , const char32_t* str )
+	{
+	  _insert(len, str);
+	}
+
+	template <typename CharT>
+	void BlockPatternMatchVector::_insert ( size_t len , const CharT* str )
+	{
+	  size_t i, wide = 0, slots = 8;
+
+	  _len = len;
+	  _block_count = (len + 63) / 64;
+	  _map.assign(256 * _block_count, 0);
+
+	  for (i = 0; i < len; i++)
+		wide += (uint32_t)str[i] > 0xff;
+	  while (slots < 2 * wide)
+		slots *= 2;
+	  if (wide) {
+		_wide_keys.assign(slots, 0);
+		_wide_map.assign(slots * _block_count, 0);
+	  }
+	  else
+		_wide_keys.clear();
+
+	  for (i = 0; i < len; i++) {
+		uint32_t ch = (uint32_t)str[i];
+		uint64_t* words;
+
+		if (ch <= 0xff)
+		  words = &_map[ch * _block_count];
+		else {
+		  size_t mask = slots - 1, slot = _wide_hash(ch) & mask;
+		  while (_wide_keys[slot] != 0 && _wide_keys[slot] != ch)
+			slot = (slot + 1) & mask;
+		  _wide_keys[slot] = ch;
+		  words = &_wide_map[slot * _block_count];
+		}
+		words[i / 64] |= (uint64_t)1 << (i % 64);
+	  }
+	}
+
+	//---------------------------------------------------------------------------
+	// Bit-parallel kernels
+	//---------------------------------------------------------------------------
+
+	static inline size_t popcount64 ( uint64_t x )
+	{
+#if defined(__GNUC__) || defined(__clang__)
+	  return (size_t)__builtin_popcountll(x);
+#else
+	  x = x - ((x >> 1) & 0x5555555555555555ULL);
+	  x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+	  x = (x + (x >> 4)) & 0x0f0f0f0f0f0f0f0fULL;
+	  return (size_t)((x * 0x0101010101010101ULL) >> 56);
+#endif
+	}
+
+	/* the key of a character in the pattern match vectors */
+	static inline unsigned char lev_char ( char ch )     { return (unsigned char)ch; }
+	static inline uint32_t      lev_char ( char16_t ch ) { return ch; }
+	static inline uint32_t      lev_char ( char32_t ch ) { return ch; }
+
+	/* a + b + carry_in, carry_out receives the overflow */
+	static inline uint64_t addc64 ( uint64_t a , uint64_t b , uint64_t carry_in , uint64_t* carry_out )
+	{
+	  uint64_t s = a + carry_in;
+	  uint64_t c = s < a;
+	  s += b;
+	  c |= s < b;
+	  *carry_out = c;
+	  return s;
+	}
+
+	//---------------------------------------------------------------------------
+
+	/* length of the longest common subsequence, pattern of at most 64 bytes */
+	template <typename PMV , typename CharT>
+	static size_t lcs_hyyro64 ( const PMV& PM , size_t len2 , const CharT* string2 )
+	{
+	  uint64_t S = ~(uint64_t)0;
+	  uint64_t mask = PM.size() < 64 ? ((uint64_t)1 << PM.size()) - 1 : ~(uint64_t)0;
+	  size_t i;
+
+	  for (i = 0; i < len2; i++) {
+		uint64_t u = S & PM.get(0, lev_char(string2[i]));
+		S = (S + u) | (S - u);
+	  }
+	  return popcount64(~S & mask);
+	}
+
+	/* same as lcs_hyyro64 for patterns of any length, the additions carry
+	 * from one block into the next */
+	template <typename CharT>
+	static size_t lcs_hyyro_block ( const BlockPatternMatchVector& PM , size_t len2 , const CharT* string2 ,
+									uint64_t* S )
+	{
+	  size_t words = PM.block_count();
+	  size_t i, w, lcs = 0;
+
+	  for (w = 0; w < words; w++)
+		S[w] = ~(uint64_t)0;
+
+	  for (i = 0; i < len2; i++) {
+		uint64_t carry = 0;
+		const auto ch = lev_char(string2[i]);
+		for (w = 0; w < words; w++) {
+		  uint64_t u = S[w] & PM.get(w, ch);
+		  uint64_t x = addc64(S[w], u, carry, &carry);
+		  S[w] = x | (S[w] - u);
+		}
+	  }
+	  for (w = 0; w < words; w++) {
+		uint64_t bits = ~S[w];
+		if (w == words - 1 && PM.size() % 64)
+		  bits &= ((uint64_t)1 << (PM.size() % 64)) - 1;
+		lcs += popcount64(bits);
+	  }
+	  return lcs;
+	}
+
+	//---------------------------------------------------------------------------
+
+	/* Levenshtein distance, pattern of at most 64 bytes. VP/VN hold the
+	 * vertical +1/-1 deltas of the current column of the cost matrix */
+	template <typename PMV , typename CharT>
+	static size_t levenshtein_myers64 ( const PMV& PM , size_t len2 , const CharT* string2 )
+	{
+	  uint64_t VP = ~(uint64_t)0;
+	  uint64_t VN = 0;
+	  uint64_t last = (uint64_t)1 << (PM.size() - 1);
+	  size_t dist = PM.size();
+	  size_t i;
+
+	  for (i = 0; i < len2; i++) {
+		uint64_t X  = PM.get(0, lev_char(string2[i]));
+		uint64_t D0 = (((X & VP) + VP) ^ VP) | X | VN;
+		uint64_t HP = VN | ~(D0 | VP);
+		uint64_t HN = D0 & VP;
+
+		dist += (HP & last) != 0;
+		dist -= (HN & last) != 0;
+
+		HP = (HP << 1) | 1;
+		HN = HN << 1;
+		VP = HN | ~(D0 | HP);
+		VN = HP & D0;
+	  }
+	  return dist;
+	}
+
+	/* same as levenshtein_myers64 for patterns of any length, the horizontal
+	 * deltas of the last row of every block are carried into the next one */
+	template <typename CharT>
+	static size_t levenshtein_myers_block ( const BlockPatternMatchVector& PM , size_t len2 , const CharT* string2 ,
+											uint64_t* VP , uint64_t* VN )
+	{
+	  size_t words = PM.block_count();
+	  uint64_t last = (uint64_t)1 << ((PM.size() - 1) % 64);
+	  size_t dist = PM.size();
+	  size_t i, w;
+
+	  for (w = 0; w < words; w++) {
+		VP[w] = ~(uint64_t)0;
+		VN[w] = 0;
+	  }
+
+	  for (i = 0; i < len2; i++) {
+		const auto ch = lev_char(string2[i]);
+		uint64_t HP_carry = 1;
+		uint64_t HN_carry = 0;
+
+		for (w = 0; w < words; w++) {
+		  uint64_t X  = PM.get(w, ch) | HN_carry;
+		  uint64_t D0 = (((X & VP[w]) + VP[w]) ^ VP[w]) | X | VN[w];
+		  uint64_t HP = VN[w] | ~(D0 | VP[w]);
+		  uint64_t HN = D0 & VP[w];
+		  uint64_t HP_in = HP_carry;
+		  uint64_t HN_in = HN_carry;
+
+		  if (w < words - 1) {
+			HP_carry = HP >> 63;
+			HN_carry = HN >> 63;
+		  }
+		  else {
+			HP_carry = (HP & last) != 0;
+			HN_carry = (HN & last) != 0;
+		  }
+
+		  HP = (HP << 1) | HP_in;
+		  HN = (HN << 1) | HN_in;
+		  VP[w] = HN | ~(D0 | HP);
+		  VN[w] = HP & D0;
+		}
+		dist += HP_carry;
+		dist -= HN_carry;
+	  }
+	  return dist;
+	}
+
+	/* first word of the band of column j whose lowest diagonal (row minus
+	 * column) is lo */
+	static inline size_t lev_band_word ( size_t j , ptrdiff_t lo )
+	{
+	  ptrdiff_t first = (ptrdiff_t)j + lo;
+
+	  return first > 0 ? (size_t)first / 64 : 0;
+	}
+
+	/* levenshtein_myers_block keeping the words of every column that hold the
+	 * diagonals lo and up: cols receives stride words of VP and of VN of
+	 * column j (i.e. after string2[j - 1]) from word lev_band_word(j, lo) on,
+	 * at cols + 2 * stride * j, and base[j] the cost at the first row of that
+	 * word. column 0 is the first column of the cost matrix, VP and VN are
+	 * PM.block_count() words of work space */
+	template <typename CharT>
+	static void levenshtein_myers_band ( const BlockPatternMatchVector& PM , size_t len2 , const CharT* string2 ,
+										 ptrdiff_t lo , size_t stride , uint64_t* VP , uint64_t* VN ,
+										 uint64_t* cols , size_t* base )
+	{
+	  size_t words = PM.block_count();
+	  uint64_t last = (uint64_t)1 << ((PM.size() - 1) % 64);
+	  size_t i, w;
+
+	  for (w = 0; w < words; w++) {
+		VP[w] = ~(uint64_t)0;
+		VN[w] = 0;
+	  }
+
+	  for (i = 0; ; i++) {
+		size_t first = lev_band_word(i, lo);
+		size_t count = first >= words ? 0 : words - first < stride ? words - first : stride;
+		size_t cost = i;
+
+		for (w = 0; w < first && w < words; w++)
+		  cost += popcount64(VP[w]) - popcount64(VN[w]);
+		base[i] = cost;
+		memcpy(cols + 2 * stride * i, VP + first, count * sizeof(uint64_t));
+		memcpy(cols + 2 * stride * i + stride, VN + first, count * sizeof(uint64_t));
+
+		if (i == len2)
+		  break;
+
+		const auto ch = lev_char(string2[i]);
+		uint64_t HP_carry = 1;
+		uint64_t HN_carry = 0;
+
+		for (w = 0; w < words; w++) {
+		  uint64_t X  = PM.get(w, ch) | HN_carry;
+		  uint64_t D0 = (((X & VP[w]) + VP[w]) ^ VP[w]) | X | VN[w];
+		  uint64_t HP = VN[w] | ~(D0 | VP[w]);
+		  uint64_t HN = D0 & VP[w];
+		  uint64_t HP_in = HP_carry;
+		  uint64_t HN_in = HN_carry;
+
+		  if (w < words - 1) {
+			HP_carry = HP >> 63;
+			HN_carry = HN >> 63;
+		  }
+		  else {
+			HP_carry = (HP & last) != 0;
+			HN_carry = (HN & last) != 0;
+		  }
+
+		  HP = (HP << 1) | HP_in;
+		  HN = (HN << 1) | HN_in;
+		  VP[w] = HN | ~(D0 | HP);
+		  VN[w] = HP & D0;
+		}
+	  }
+	}
+
+	//---------------------------------------------------------------------------
+
+	size_t lev_bitpal_distance ( const PatternMatchVector& PM,
+								 size_t len2  , const char* string2,
+								 int    xcost )
+	{
+	  if (PM.size() == 0)
+		return len2;
+	  if (len2 == 0)
+		return PM.size();
+
+	  if (xcost)
+		return PM.size() + len2 - 2 * lcs_hyyro64(PM, len2, string2);
+	  else
+		return levenshtein_myers64(PM, len2, string2);
+	}
+
+	template <typename CharT>
+	static size_t lev_bitpal_block ( const BlockPatternMatchVector& PM,
+									 size_t len2  , const CharT* string2,
+									 int    xcost , LevScratch& scratch )
+	{
+	  size_t words = PM.block_count();
+
+	  if (PM.size() == 0)
+		return len2;
+	  if (len2 == 0)
+		return PM.size();
+	  if (words == 1)
+		return xcost ?
+			   PM.size() + len2 - 2 * lcs_hyyro64(PM, len2, string2) :
+			   levenshtein_myers64(PM, len2, string2);
+
+	  if (scratch.words.size() < 2 * words)
+		scratch.words.resize(2 * words);
+
+	  if (xcost)
+		return PM.size() + len2 - 2 * lcs_hyyro_block(PM, len2, string2, &scratch.words[0]);
+	  else
+		return levenshtein_myers_block(PM, len2, string2, &scratch.words[0], &scratch.words[words]);
+	}
+
+	size_t lev_bitpal_distance ( const BlockPatternMatchVector& PM,
+								 size_t len2  , const char* string2,
+								 int    xcost )
+	{
+	  return lev_bitpal_distance(PM, len2, string2, xcost, lev_thread_scratch());
+	}
+
+	size_t lev_bitpal_distance ( const BlockPatternMatchVector& PM,
+								 size_t len2  , const char* string2,
+								 int    xcost , LevScratch& scratch )
+	{
+	  return lev_bitpal_block(PM, len2, string2, xcost, scratch);
+	}
+
+	//---------------------------------------------------------------------------
+
+	LevScratch& lev_thread_scratch ( void )
+	{
+	  static thread_local LevScratch scratch;
+	  return scratch;
+	}
+
+	//---------------------------------------------------------------------------
+
+	template <typename CharT>
+	static size_t lev_edit_distance_impl ( size_t len1  , const CharT* string1,
+										   size_t len2  , const CharT* string2,
+										   int    xcost , LevScratch& scratch )
+	{
+	  /* strip common prefix */
+	  while (len1 > 0 && len2 > 0 && *string1 == *string2) {
+		len1--;
+		len2--;
+		string1++;
+		string2++;
+	  }
+
+	  /* strip common suffix */
+	  while (len1 > 0 && len2 > 0 && string1[len1-1] == string2[len2-1]) {
+		len1--;
+		len2--;
+	  }
+
+	  /* catch trivial cases */
+	  if (len1 == 0)
+		return len2;
+	  if (len2 == 0)
+		return len1;
+
+	  /* make the pattern (i.e. string1) the shorter one */
+	  if (len1 > len2) {
+		size_t nx = len1;
+		const CharT* sx = string1;
+		len1 = len2;
+		len2 = nx;
+		string1 = string2;
+		string2 = sx;
+	  }
+	  /* check len1 == 1 separately */
+	  if (len1 == 1) {
+		if (xcost)
+		  return len2 + 1 - 2*(std::char_traits<CharT>::find(string2, len2, *string1) != NULL);
+		else
+		  return len2 - (std::char_traits<CharT>::find(string2, len2, *string1) != NULL);
+	  }
+
+	  /* one machine word covers the whole pattern (of bytes, code points
+	   * need the hash map of the block vector) */
+	  if (sizeof(CharT) == 1 && len1 <= 64) {
+		PatternMatchVector PM(len1, (const char*)string1);
+		return lev_bitpal_distance(PM, len2, (const char*)string2, xcost);
+	  }
+	  else {
+		scratch.PM.insert(len1, string1);
+		return lev_bitpal_block(scratch.PM, len2, string2, xcost, scratch);
+	  }
+	}
+
 	size_t lev_edit_distance ( size_t len1  , const char* string1,
 							   size_t len2  , const char* string2,
 							   int    xcost )
+	{
+	  return lev_edit_distance(len1, string1, len2, string2, xcost, lev_thread_scratch());
+	}
+
+	size_t lev_edit_distance ( size_t len1  , const char* string1,
+							   size_t len2  , const char* string2,
+							   int    xcost , LevScratch& scratch )
+	{
+	  return lev_edit_distance_impl(len1, string1, len2, string2, xcost, scratch);
+	}
+
+	//---------------------------------------------------------------------------
+	// One-vs-many kernels
+	//---------------------------------------------------------------------------
+
+	/* string1 as seen by the one-vs-many kernels: its distinct characters
+	 * are numbered 1 .. slots - 1, all the others share slot 0. The pattern
+	 * match vectors only need one entry per slot. */
+	struct LevLanesText
+	{
+	  size_t len1;
+	  const char* string1;
+	  uint16_t slot[256];
+	  size_t slots;
+	};
+
+	typedef void (*LevLanesKernel) ( int width , const LevLanesText& text ,
+									 size_t count , const size_t* index ,
+									 const char* const* strings , const size_t* lens ,
+									 int xcost , void* pm , size_t* dist );
+
+	/* The lanes are GCC vector extensions, compiled for x86 only: elsewhere
+	 * lev_lanes_kernel finds no kernel and every string is scored alone. */
+#ifdef FUZZYWUZZY_X86
+
+	/* Runs the bit-parallel kernels for count strings at once, the pattern of
+	 * strings[index[k]] living in lane k of Bytes wide vectors of Lane, and
+	 * string1 being the text. Every string must fit its lane, pm has room for
+	 * text.slots vectors. The distance is read from the last column: len1
+	 * plus the vertical deltas of the rows of the pattern. */
+	template <typename Lane , size_t Bytes>
+	static inline __attribute__((always_inline))
+	void lev_lanes_distance ( const LevLanesText& text ,
+							  size_t count , const size_t* index ,
+							  const char* const* strings , const size_t* lens ,
+							  int xcost , void* pm , size_t* dist )
+	{
+	  typedef Lane V __attribute__((vector_size(Bytes)));
+	  const size_t lanes = Bytes / sizeof(Lane);
+	  const size_t len1 = text.len1;
+	  const unsigned char* string1 = (const unsigned char*)text.string1;
+	  V* PM = (V*)pm;
+	  Lane* PM_lanes = (Lane*)pm;
+	  const V zero = {};
+	  V VP = ~zero, VN = zero;
+	  size_t i, k;
+
+	  for (i = 0; i < text.slots; i++)
+		PM[i] = zero;
+	  for (k = 0; k < count; k++) {
+		const unsigned char* s = (const unsigned char*)strings[index[k]];
+		const size_t len2 = lens[index[k]];
+		Lane* lane = PM_lanes + k;
+		for (i = 0; i < len2; i++)
+		  lane[text.slot[s[i]] * lanes] |= (Lane)((Lane)1 << i);
+	  }
+
+	  if (xcost) {
+		/* VP is Hyyro's S here */
+		for (i = 0; i < len1; i++) {
+		  V u = VP & PM[text.slot[string1[i]]];
+		  VP = (VP + u) | (VP - u);
+		}
+		VN = ~VP;
+		VP = zero;
+	  }
+	  else {
+		for (i = 0; i < len1; i++) {
+		  V X  = PM[text.slot[string1[i]]];
+		  V D0 = (((X & VP) + VP) ^ VP) | X | VN;
+		  V HP = VN | ~(D0 | VP);
+		  V HN = D0 & VP;
+
+		  HP = (HP << 1) | (Lane)1;
+		  HN = HN << 1;
+		  VP = HN | ~(D0 | HP);
+		  VN = HP & D0;
+		}
+	  }
+
+	  for (k = 0; k < count; k++) {
+		size_t len2 = lens[index[k]];
+		uint64_t mask = len2 < 64 ? ((uint64_t)1 << len2) - 1 : ~(uint64_t)0;
+		size_t plus = popcount64((uint64_t)VP[k] & mask);
+		size_t minus = popcount64((uint64_t)VN[k] & mask);
+
+		/* the LCS is counted in minus, and costs 2 per common character */
+		dist[index[k]] = xcost ? len1 + len2 - 2 * minus : len1 + plus - minus;
+	  }
+	}
+
+	/* lane width 8 << width */
+	template <size_t Bytes>
+	static inline __attribute__((always_inline))
+	void lev_lanes_dispatch ( int width , const LevLanesText& text ,
+							  size_t count , const size_t* index ,
+							  const char* const* strings , const size_t* lens ,
+							  int xcost , void* pm , size_t* dist )
+	{
+	  switch (width) {
+		case 0:
+		  lev_lanes_distance<uint8_t, Bytes>(text, count, index, strings, lens, xcost, pm, dist);
+		  break;
+		case 1:
+		  lev_lanes_distance<uint16_t, Bytes>(text, count, index, strings, lens, xcost, pm, dist);
+		  break;
+		case 2:
+		  lev_lanes_distance<uint32_t, Bytes>(text, count, index, strings, lens, xcost, pm, dist);
+		  break;
+		default:
+		  lev_lanes_distance<uint64_t, Bytes>(text, count, index, strings, lens, xcost, pm, dist);
+		  break;
+	  }
+	}
+
+	__attribute__((target("sse2")))
+	static void lev_lanes_sse2 ( int width , const LevLanesText& text ,
+								 size_t count , const size_t* index ,
+								 const char* const* strings , const size_t* lens ,
+								 int xcost , void* pm , size_t* dist )
+	{
+	  lev_lanes_dispatch<16>(width, text, count, index, strings, lens, xcost, pm, dist);
+	}
+
+	__attribute__((target("avx2")))
+	static void lev_lanes_avx2 ( int width , const LevLanesText& text ,
+								 size_t count , const size_t* index ,
+								 const char* const* strings , const size_t* lens ,
+								 int xcost , void* pm , size_t* dist )
+	{
+	  lev_lanes_dispatch<32>(width, text, count, index, strings, lens, xcost, pm, dist);
+	}
+
+	__attribute__((target("avx512f,avx512bw")))
+	static void lev_lanes_avx512 ( int width , const LevLanesText& text ,
+								   size_t count , const size_t* index ,
+								   const char* const* strings , const size_t* lens ,
+								   int xcost , void* pm , size_t* dist )
+	{
+	  lev_lanes_dispatch<64>(width, text, count, index, strings, lens, xcost, pm, dist);
+	}
+
+#endif
+
+	/* the widest kernel the CPU runs and its vector size in bytes, none
+	 * (i.e. one pair at a time) without SIMD */
+	static LevLanesKernel lev_lanes_kernel ( size_t* bytes )
+	{
+#ifdef FUZZYWUZZY_X86
+	  if (__builtin_cpu_supports("avx512bw")) {
+		*bytes = 64;
+		return lev_lanes_avx512;
+	  }
+	  if (__builtin_cpu_supports("avx2")) {
+		*bytes = 32;
+		return lev_lanes_avx2;
+	  }
+	  if (__builtin_cpu_supports("sse2")) {
+		*bytes = 16;
+		return lev_lanes_sse2;
+	  }
+#endif
+	  *bytes = 0;
+	  return NULL;
+	}
+
+	//---------------------------------------------------------------------------
+
+	void lev_edit_distance_many ( size_t len1  , const char* string1,
+								  size_t count , const char* const* strings , const size_t* lens ,
+								  int    xcost , size_t* dist )
+	{
+	  lev_edit_distance_many(len1, string1, count, strings, lens, xcost, dist, lev_thread_scratch());
+	}
+
+	void lev_edit_distance_many ( size_t len1  , const char* string1,
+								  size_t count , const char* const* strings , const size_t* lens ,
+								  int    xcost , size_t* dist , LevScratch& scratch )
+	{
+	  static size_t bytes;
+	  static const LevLanesKernel kernel = lev_lanes_kernel(&bytes);
+	  size_t pending[4][64];
+	  size_t fill[4] = {0, 0, 0, 0};
+	  LevLanesText text;
+	  void* pm;
+	  size_t k;
+	  int width;
+
+	  if (kernel == NULL) {
+		for (k = 0; k < count; k++)
+		  dist[k] = lev_edit_distance(len1, string1, lens[k], strings[k], xcost, scratch);
+		return;
+	  }
+
+	  text.len1 = len1;
+	  text.string1 = string1;
+	  text.slots = 1;
+	  memset(text.slot, 0, sizeof(text.slot));
+	  for (k = 0; k < len1; k++)
+		if (text.slot[(unsigned char)string1[k]] == 0)
+		  text.slot[(unsigned char)string1[k]] = (uint16_t)text.slots++;
+
+	  /* one vector of up to 64 bytes per slot, aligned for the widest kernel */
+	  if (scratch.lanes.size() < text.slots * 8 + 8)
+		scratch.lanes.resize(text.slots * 8 + 8);
+	  pm = (void*)(((uintptr_t)&scratch.lanes[0] + 63) & ~(uintptr_t)63);
+
+	  /* strings are grouped by the narrowest lane they fit, a group runs as
+	   * soon as it fills a vector */
+	  for (k = 0; k < count; k++) {
+		if (lens[k] > 64) {
+		  dist[k] = lev_edit_distance(len1, string1, lens[k], strings[k], xcost, scratch);
+		  continue;
+		}
+		width = lens[k] <= 8 ? 0 : lens[k] <= 16 ? 1 : lens[k] <= 32 ? 2 : 3;
+		pending[width][fill[width]++] = k;
+		if (fill[width] == bytes >> width) {
+		  kernel(width, text, fill[width], pending[width], strings, lens, xcost, pm, dist);
+		  fill[width] = 0;
+		}
+	  }
+
+	  for (width = 0; width < 4; width++)
+		if (fill[width])
+		  kernel(width, text, fill[width], pending[width], strings, lens, xcost, pm, dist);
+	}
+
+	//---------------------------------------------------------------------------
+
+	/* Banded version of the single-row DP: with a distance limit of max only
+	 * the diagonals d = j - i in [dmin, dmax] can be part of a path of cost
+	 * <= max. Returns max + 1 as soon as no cell of the current row can reach
+	 * the end within the limit. */
+	template <typename CharT>
+	static size_t lev_edit_distance_banded_impl ( size_t len1  , const CharT* string1,
+												  size_t len2  , const CharT* string2,
+												  int    xcost , size_t max ,
+												  LevScratch& scratch )
+	{
+	  size_t i, j, diff, big;
+	  ptrdiff_t dmin, dmax;
+	  size_t *row;
+
+	  /* make the inner cycle (i.e. string2) the longer one */
+	  if (len1 > len2) {
+		size_t nx = len1;
+		const CharT* sx = string1;
+		len1 = len2;
+		len2 = nx;
+		string1 = string2;
+		string2 = sx;
+	  }
+	  diff = len2 - len1;
+	  if (diff > max)
+		return max + 1;
+	  if (len1 == 0)
+		return len2;
+
+	  big = max + 1;
+	  dmin = -(ptrdiff_t)((max - diff) / 2);
+	  dmax = (ptrdiff_t)(diff + (max - diff) / 2);
+
+	  if (scratch.row.size() < len2 + 1)
+		scratch.row.resize(len2 + 1);
+	  row = &scratch.row[0];
+	  for (j = 0; j <= len2 && (ptrdiff_t)j <= dmax; j++)
+		row[j] = j;
+
+	  for (i = 1; i <= len1; i++) {
+		const CharT char1 = string1[i - 1];
+		size_t jlo = (ptrdiff_t)i + dmin > 0 ? (size_t)((ptrdiff_t)i + dmin) : 0;
+		size_t jhi = (size_t)((ptrdiff_t)i + dmax) < len2 ? (size_t)((ptrdiff_t)i + dmax) : len2;
+		size_t diag, left, best = big;
+
+		/* the cell above the new rightmost one lies outside the previous band */
+		if ((ptrdiff_t)jhi > (ptrdiff_t)(i - 1) + dmax)
+		  row[jhi] = big;
+
+		if (jlo == 0) {
+		  diag = row[0];
+		  left = row[0] = i;
+		  j = 1;
+		}
+		else {
+		  diag = row[jlo - 1];
+		  left = big;
+		  j = jlo;
+		}
+
+		for (; j <= jhi; j++) {
+		  size_t up = row[j];
+		  size_t x = diag + (char1 == string2[j - 1] ? 0 : (xcost ? 2 : 1));
+		  size_t rest, lower;
+
+		  if (x > up + 1)
+			x = up + 1;
+		  if (x > left + 1)
+			x = left + 1;
+		  if (x > big)
+			x = big;
+		  diag = up;
+		  row[j] = left = x;
+
+		  /* cost still needed to reach (len1, len2) from here */
+		  rest = (len2 - j) > (len1 - i) ? (len2 - j) - (len1 - i) : (len1 - i) - (len2 - j);
+		  lower = x + rest;
+		  if (lower < best)
+			best = lower;
+		}
+
+		if (best > max)
+		  return big;
+	  }
+
+	  return row[len2] > max ? big : row[len2];
+	}
+
+	size_t lev_edit_distance_banded ( size_t len1  , const char* string1,
+									  size_t len2  , const char* string2,
+									  int    xcost , size_t max )
+	{
+	  return lev_edit_distance_banded(len1, string1, len2, string2, xcost, max, lev_thread_scratch());
+	}
+
+	size_t lev_edit_distance_banded ( size_t len1  , const char* string1,
+									  size_t len2  , const char* string2,
+									  int    xcost , size_t max ,
+									  LevScratch& scratch )
+	{
+	  return lev_edit_distance_banded_impl(len1, string1, len2, string2, xcost, max, scratch);
+	}
+
+	//---------------------------------------------------------------------------
+
+	template <typename CharT>
+	static size_t lev_edit_distance_impl ( size_t len1  , const CharT* string1,
+										   size_t len2  , const CharT* string2,
+										   int    xcost , size_t max ,
+										   LevScratch& scratch )
+	{
+	  size_t dist, band;
+
+	  /* no differences allowed: a plain comparison is enough */
+	  if (max == 0)
+		return len1 != len2 || memcmp(string1, string2, len1 * sizeof(CharT)) != 0;
+
+	  /* strip common prefix */
+	  while (len1 > 0 && len2 > 0 && *string1 == *string2) {
+		len1--;
+		len2--;
+		string1++;
+		string2++;
+	  }
+
+	  /* strip common suffix */
+	  while (len1 > 0 && len2 > 0 && string1[len1-1] == string2[len2-1]) {
+		len1--;
+		len2--;
+	  }
+
+	  /* the length difference is a lower bound for both distances */
+	  if ((len1 > len2 ? len1 - len2 : len2 - len1) > max)
+		return max + 1;
+
+	  if (len1 == 0 || len2 == 0)
+		return len1 + len2;
+
+	  /* the bit-parallel kernels always process the whole matrix, 64 cells per
+	   * word: a band narrower than one cell per word is cheaper, and it can
+	   * also stop early */
+	  band = max + 1;
+	  if (band * 64 < (len1 < len2 ? len1 : len2))
+		return lev_edit_distance_banded_impl(len1, string1, len2, string2, xcost, max, scratch);
+
+	  dist = lev_edit_distance_impl(len1, string1, len2, string2, xcost, scratch);
+	  return dist > max ? max + 1 : dist;
+	}
+
+	size_t lev_edit_distance ( size_t len1  , const char* string1,
+							   size_t len2  , const char* string2,
+							   int    xcost , size_t max )
+	{
+	  return lev_edit_distance(len1, string1, len2, string2, xcost, max, lev_thread_scratch());
+	}
+
+	size_t lev_edit_distance ( size_t len1  , const char* string1,
+							   size_t len2  , const char* string2,
+							   int    xcost , size_t max ,
+							   LevScratch& scratch )
+	{
+	  return lev_edit_distance_impl(len1, string1, len2, string2, xcost, max, scratch);
+	}
+
+	//---------------------------------------------------------------------------
+
+	size_t lev_edit_distance_dp ( size_t len1  , const char* string1,
+								  size_t len2  , const char* string2,
+								  int    xcost )
 	{
 	  size_t i;
 	  size_t *row;  /* we only need to keep one row of costs */
@@ -148,5 +1016,396 @@ namespace FuzzyWuzzy
 	  return i;
 	}
 
-}
+	//---------------------------------------------------------------------------
+	// Edit operations
+	//---------------------------------------------------------------------------
+
+	/* cost matrix entry D(i, j) from the band kept by levenshtein_myers_band,
+	 * summing the vertical deltas of column j from the base of its band. The
+	 * cells off the diagonals lo .. hi are on no optimal path: they get a cost
+	 * that no move of the traceback matches */
+	static size_t lev_band_cost ( const uint64_t* cols , const size_t* base , ptrdiff_t lo , ptrdiff_t hi ,
+								  size_t stride , size_t i , size_t j )
+	{
+	  ptrdiff_t diagonal = (ptrdiff_t)i - (ptrdiff_t)j;
+
+	  if (diagonal < lo || diagonal > hi)
+		return SIZE_MAX / 2;
+
+	  const uint64_t *VP = cols + 2 * stride * j;
+	  const uint64_t *VN = VP + stride;
+	  size_t first = lev_band_word(j, lo);
+	  size_t w, cost = base[j];
 
+	  for (w = first; w < i / 64; w++)
+		cost += popcount64(VP[w - first]) - popcount64(VN[w - first]);
+	  if (i % 64) {
+		uint64_t mask = ((uint64_t)1 << (i % 64)) - 1;
+		cost += popcount64(VP[w - first] & mask) - popcount64(VN[w - first] & mask);
+	  }
+	  return cost;
+	}
+
+	/* D(i - 1, j) given cost == D(i, j) */
+	static inline size_t lev_band_cost_above ( const uint64_t* cols , const size_t* base , ptrdiff_t lo , ptrdiff_t hi ,
+											   size_t stride , size_t i , size_t j , size_t cost )
+	{
+	  ptrdiff_t diagonal = (ptrdiff_t)(i - 1) - (ptrdiff_t)j;
+
+	  if (diagonal < lo || diagonal > hi)
+		return SIZE_MAX / 2;
+	  /* D(i, j) is off the band */
+	  if (diagonal == hi)
+		return lev_band_cost(cols, base, lo, hi, stride, i - 1, j);
+
+	  const uint64_t *VP = cols + 2 * stride * j;
+	  const uint64_t *VN = VP + stride;
+	  size_t w = (i - 1) / 64 - lev_band_word(j, lo);
+	  uint64_t bit = (uint64_t)1 << ((i - 1) % 64);
+
+	  return cost - ((VP[w] & bit) != 0) + ((VN[w] & bit) != 0);
+	}
+
+	template <typename CharT>
+	static void lev_editops_find_impl ( size_t len1  , const CharT* string1,
+										size_t len2  , const CharT* string2,
+										std::vector<LevEditOp>& ops , LevScratch& scratch )
+	{
+	  size_t i, j, off, words, cost, guess, pos, stride;
+	  ptrdiff_t lo, hi;
+	  const uint64_t *cols;
+	  size_t *base;
+	  int dir = 0;
+
+	  ops.clear();
+
+	  /* strip common prefix */
+	  off = 0;
+	  while (len1 > 0 && len2 > 0 && *string1 == *string2) {
+		len1--;
+		len2--;
+		string1++;
+		string2++;
+		off++;
+	  }
+
+	  /* strip common suffix */
+	  while (len1 > 0 && len2 > 0 && string1[len1-1] == string2[len2-1]) {
+		len1--;
+		len2--;
+	  }
+
+	  /* the cells of optimal paths lie within cost edits of both corners:
+	   * only the diagonals lo .. hi of the columns are kept, string1 running
+	   * down. Up to 256 KB the whole columns are kept, otherwise the band of a
+	   * guess at the cost first, and again the band of the cost found when
+	   * that was too narrow */
+	  words = (len1 + 63) / 64;
+	  if (len1 > 0)
+		scratch.PM.insert(len1, string1);
+	  if (scratch.row.size() < len2 + 1)
+		scratch.row.resize(len2 + 1);
+	  base = &scratch.row[0];
+
+	  if (2 * words * (len2 + 1) <= 32768)
+		guess = len1 > len2 ? len1 : len2;
+	  else
+		guess = (len1 > len2 ? len1 - len2 : len2 - len1) + 128;
+	  for (;;) {
+		hi = ((ptrdiff_t)guess + (ptrdiff_t)len1 - (ptrdiff_t)len2) / 2;
+		lo = -(((ptrdiff_t)guess - (ptrdiff_t)len1 + (ptrdiff_t)len2) / 2);
+		stride = (size_t)(hi - lo) / 64 + 2;
+		if (stride > words)
+		  stride = words;
+
+		if (scratch.words.size() < 2 * words + 2 * stride * (len2 + 1))
+		  scratch.words.resize(2 * words + 2 * stride * (len2 + 1));
+		cols = &scratch.words[2 * words];
+		if (len1 > 0)
+		  levenshtein_myers_band(scratch.PM, len2, string2, lo, stride, &scratch.words[0], &scratch.words[words],
+								 &scratch.words[2 * words], base);
+		else
+		  for (j = 0; j <= len2; j++)
+			base[j] = j;
+
+		cost = lev_band_cost(cols, base, lo, hi, stride, len1, len2);
+		if (cost <= guess)
+		  break;
+		guess = cost;
+	  }
+
+	  if (cost == 0)
+		return;
+	  ops.resize(cost);
+
+	  /* find the way back, preferring to continue in the same direction */
+	  pos = cost;
+	  i = len1;
+	  j = len2;
+	  while (i || j) {
+		size_t left = j ? lev_band_cost(cols, base, lo, hi, stride, i, j - 1) : 0;
+		size_t up   = i ? lev_band_cost_above(cols, base, lo, hi, stride, i, j, cost) : 0;
+		size_t diag = i && j ? lev_band_cost_above(cols, base, lo, hi, stride, i, j - 1, left) : 0;
+
+		if (dir < 0 && j && cost == left + 1) {
+		  pos--;
+		  ops[pos].type = LEV_EDIT_INSERT;
+		  ops[pos].spos = i + off;
+		  ops[pos].dpos = --j + off;
+		  cost = left;
+		  continue;
+		}
+		if (dir > 0 && i && cost == up + 1) {
+		  pos--;
+		  ops[pos].type = LEV_EDIT_DELETE;
+		  ops[pos].spos = --i + off;
+		  ops[pos].dpos = j + off;
+		  cost = up;
+		  continue;
+		}
+		if (i && j && cost == diag && string1[i - 1] == string2[j - 1]) {
+		  /* don't store LEV_EDIT_KEEP */
+		  i--;
+		  j--;
+		  dir = 0;
+		  continue;
+		}
+		if (i && j && cost == diag + 1) {
+		  pos--;
+		  ops[pos].type = LEV_EDIT_REPLACE;
+		  ops[pos].spos = --i + off;
+		  ops[pos].dpos = --j + off;
+		  cost = diag;
+		  dir = 0;
+		  continue;
+		}
+		/* we can't turn directly from -1 to 1, in this case it would be better
+		 * to go diagonally, but check it (dir == 0) */
+		if (dir == 0 && j && cost == left + 1) {
+		  pos--;
+		  ops[pos].type = LEV_EDIT_INSERT;
+		  ops[pos].spos = i + off;
+		  ops[pos].dpos = --j + off;
+		  cost = left;
+		  dir = -1;
+		  continue;
+		}
+		if (dir == 0 && i && cost == up + 1) {
+		  pos--;
+		  ops[pos].type = LEV_EDIT_DELETE;
+		  ops[pos].spos = --i + off;
+		  ops[pos].dpos = j + off;
+		  cost = up;
+		  dir = 1;
+		  continue;
+		}
+		/* one of the moves above always fits once the direction is reset */
+		dir = 0;
+	  }
+	}
+
+	void lev_editops_find ( size_t len1  , const char* string1,
+							size_t len2  , const char* string2,
+							std::vector<LevEditOp>& ops )
+	{
+	  lev_editops_find(len1, string1, len2, string2, ops, lev_thread_scratch());
+	}
+
+	void lev_editops_find ( size_t len1  , const char* string1,
+							size_t len2  , const char* string2,
+							std::vector<LevEditOp>& ops , LevScratch& scratch )
+	{
+	  lev_editops_find_impl(len1, string1, len2, string2, ops, scratch);
+	}
+
+	//---------------------------------------------------------------------------
+
+	void lev_editops_matching_blocks ( size_t len1 , size_t len2 ,
+									   const std::vector<LevEditOp>& ops ,
+									   std::vector<LevMatchingBlock>& blocks )
+	{
+	  size_t k = 0, n = ops.size();
+	  size_t spos = 0, dpos = 0;
+	  LevMatchingBlock mb;
+
+	  blocks.clear();
+	  while (k < n) {
+		LevEditType type = ops[k].type;
+
+		/* simply pretend there are no keep blocks */
+		if (type == LEV_EDIT_KEEP) {
+		  k++;
+		  continue;
+		}
+		if (spos < ops[k].spos || dpos < ops[k].dpos) {
+		  mb.spos = spos;
+		  mb.dpos = dpos;
+		  mb.len = ops[k].spos - spos;
+		  blocks.push_back(mb);
+		  spos = ops[k].spos;
+		  dpos = ops[k].dpos;
+		}
+		do {
+		  if (type != LEV_EDIT_INSERT)
+			spos++;
+		  if (type != LEV_EDIT_DELETE)
+			dpos++;
+		  k++;
+		} while (k < n && ops[k].type == type && spos == ops[k].spos && dpos == ops[k].dpos);
+	  }
+	  if (spos < len1 || dpos < len2) {
+		mb.spos = spos;
+		mb.dpos = dpos;
+		mb.len = len1 - spos;
+		blocks.push_back(mb);
+	  }
+	}
+
+	//---------------------------------------------------------------------------
+
+	template <typename CharT>
+	static void lev_matching_blocks_impl ( size_t len1  , const CharT* string1,
+										   size_t len2  , const CharT* string2,
+										   std::vector<LevMatchingBlock>& blocks ,
+										   LevScratch& scratch )
+	{
+	  LevMatchingBlock last;
+
+	  lev_editops_find_impl(len1, string1, len2, string2, scratch.ops, scratch);
+	  lev_editops_matching_blocks(len1, len2, scratch.ops, blocks);
+
+	  last.spos = len1;
+	  last.dpos = len2;
+	  last.len = 0;
+	  blocks.push_back(last);
+	}
+
+	void lev_matching_blocks ( size_t len1  , const char* string1,
+							   size_t len2  , const char* string2,
+							   std::vector<LevMatchingBlock>& blocks ,
+							   LevScratch& scratch )
+	{
+	  lev_matching_blocks_impl(len1, string1, len2, string2, blocks, scratch);
+	}
+
+	//---------------------------------------------------------------------------
+	// UTF-16 code units and code points
+	//---------------------------------------------------------------------------
+
+	size_t lev_edit_distance ( size_t len1  , const char16_t* string1,
+							   size_t len2  , const char16_t* string2,
+							   int    xcost )
+	{
+	  return lev_edit_distance_impl(len1, string1, len2, string2, xcost, lev_thread_scratch());
+	}
+
+	size_t lev_edit_distance ( size_t len1  , const char16_t* string1,
+							   size_t len2  , const char16_t* string2,
+							   int    xcost , LevScratch& scratch )
+	{
+	  return lev_edit_distance_impl(len1, string1, len2, string2, xcost, scratch);
+	}
+
+	size_t lev_edit_distance ( size_t len1  , const char16_t* string1,
+							   size_t len2  , const char16_t* string2,
+							   int    xcost , size_t max )
+	{
+	  return lev_edit_distance_impl(len1, string1, len2, string2, xcost, max, lev_thread_scratch());
+	}
+
+	size_t lev_edit_distance ( size_t len1  , const char16_t* string1,
+							   size_t len2  , const char16_t* string2,
+							   int    xcost , size_t max ,
+							   LevScratch& scratch )
+	{
+	  return lev_edit_distance_impl(len1, string1, len2, string2, xcost, max, scratch);
+	}
+
+	size_t lev_bitpal_distance ( const BlockPatternMatchVector& PM,
+								 size_t len2  , const char16_t* string2,
+								 int    xcost )
+	{
+	  return lev_bitpal_block(PM, len2, string2, xcost, lev_thread_scratch());
+	}
+
+	size_t lev_bitpal_distance ( const BlockPatternMatchVector& PM,
+								 size_t len2  , const char16_t* string2,
+								 int    xcost , LevScratch& scratch )
+	{
+	  return lev_bitpal_block(PM, len2, string2, xcost, scratch);
+	}
+
+	void lev_editops_find ( size_t len1  , const char16_t* string1,
+							size_t len2  , const char16_t* string2,
+							std::vector<LevEditOp>& ops , LevScratch& scratch )
+	{
+	  lev_editops_find_impl(len1, string1, len2, string2, ops, scratch);
+	}
+
+	void lev_matching_blocks ( size_t len1  , const char16_t* string1,
+							   size_t len2  , const char16_t* string2,
+							   std::vector<LevMatchingBlock>& blocks ,
+							   LevScratch& scratch )
+	{
+	  lev_matching_blocks_impl(len1, string1, len2, string2, blocks, scratch);
+	}
+
+	size_t lev_edit_distance ( size_t len1  , const char32_t* string1,
+							   size_t len2  , const char32_t* string2,
+							   int    xcost )
+	{
+	  return lev_edit_distance_impl(len1, string1, len2, string2, xcost, lev_thread_scratch());
+	}
+
+	size_t lev_edit_distance ( size_t len1  , const char32_t* string1,
+							   size_t len2  , const char32_t* string2,
+							   int    xcost , LevScratch& scratch )
+	{
+	  return lev_edit_distance_impl(len1, string1, len2, string2, xcost, scratch);
+	}
+
+	size_t lev_edit_distance ( size_t len1  , const char32_t* string1,
+							   size_t len2  , const char32_t* string2,
+							   int    xcost , size_t max )
+	{
+	  return lev_edit_distance_impl(len1, string1, len2, string2, xcost, max, lev_thread_scratch());
+	}
+
+	size_t lev_edit_distance ( size_t len1  , const char32_t* string1,
+							   size_t len2  , const char32_t* string2,
+							   int    xcost , size_t max ,
+							   LevScratch& scratch )
+	{
+	  return lev_edit_distance_impl(len1, string1, len2, string2, xcost, max, scratch);
+	}
+
+	size_t lev_bitpal_distance ( const BlockPatternMatchVector& PM,
+								 size_t len2  , const char32_t* string2,
+								 int    xcost )
+	{
+	  return lev_bitpal_block(PM, len2, string2, xcost, lev_thread_scratch());
+	}
+
+	size_t lev_bitpal_distance ( const BlockPatternMatchVector& PM,
+								 size_t len2  , const char32_t* string2,
+								 int    xcost , LevScratch& scratch )
+	{
+	  return lev_bitpal_block(PM, len2, string2, xcost, scratch);
+	}
+
+	void lev_editops_find ( size_t len1  , const char32_t* string1,
+							size_t len2  , const char32_t* string2,
+							std::vector<LevEditOp>& ops , LevScratch& scratch )
+	{
+	  lev_editops_find_impl(len1, string1, len2, string2, ops, scratch);
+	}
+
+	void lev_matching_blocks ( size_t len1  , const char32_t* string1,
+							   size_t len2  , const char32_t* string2,
+							   std::vector<LevMatchingBlock>& blocks ,
+							   LevScratch& scratch )
+	{
+	  lev_matching_blocks_impl(len1, string1, len2, string2, blocks, scratch);
+	}
+
+}
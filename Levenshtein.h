@@ -7,12 +7,305 @@
 
 #include <string.h>
 #include <stdlib.h>
-#include <cstdlib.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
 
 namespace FuzzyWuzzy
 {
-	size_t lev_edit_distance ( size_t len1  , const char* string1,
+	/* Bit-parallel pattern match vector for patterns of at most 64 bytes:
+	*   bit i of get(0, c) is set when pattern[i] == c
+	*/
+	class PatternMatchVector
+	{
+	private :
+
+		uint64_t _map[256];
+		size_t   _len;
+
+	public:
+
+		PatternMatchVector ( void );
+		PatternMatchVector ( size_t len , const char* str );
+
+		void insert ( size_t len , const char* str );
+
+		size_t   size        ( void ) const { return _len; }
+		size_t   block_count ( void ) const { return 1; }
+		uint64_t get ( size_t , unsigned char ch ) const { return _map[ch]; }
+	};
+
+	//---------------------------------------------------------------------------
+
+	/* Same as PatternMatchVector for patterns of any length, split in blocks of
+	*   64 bits. The words of one character are stored next to each other.
+	*   Patterns of code points keep the words of the characters above 0xff in
+	*   an open addressing hash map, at most half full.
+	*/
+	class BlockPatternMatchVector
+	{
+	private :
+
+		std::vector<uint64_t> _map;
+		std::vector<uint32_t> _wide_keys;   /* 0 marks a free slot */
+		std::vector<uint64_t> _wide_map;
+		size_t                _len;
+		size_t                _block_count;
+
+		static size_t _wide_hash ( uint32_t ch ) { return (size_t) ( ( ch * 0x9E3779B97F4A7C15ULL ) >> 40 ); }
+
+		template <typename CharT>
+		void _insert ( size_t len , const CharT* str );
+
+	public:
+
+		BlockPatternMatchVector ( void );
+		BlockPatternMatchVector ( size_t len , const char* str );
+
+		void insert ( size_t len , const char*     str );
+		void insert ( size_t len , const char16_t* str );
+		void insert ( size_t len , const char32_t* str );
+
+		size_t   size        ( void ) const { return _len; }
+		size_t   block_count ( void ) const { return _block_count; }
+		uint64_t get ( size_t block , unsigned char ch ) const { return _map[ch * _block_count + block]; }
+
+		uint64_t get ( size_t block , uint32_t ch ) const
+		{
+			if ( ch < 256 )
+				return _map[ch * _block_count + block];
+			if ( _wide_keys.empty() )
+				return 0;
+
+			size_t mask = _wide_keys.size() - 1;
+
+			for ( size_t i = _wide_hash ( ch ) & mask ; ; i = ( i + 1 ) & mask )
+			{
+				if ( _wide_keys[i] == ch )
+					return _wide_map[i * _block_count + block];
+				if ( _wide_keys[i] == 0 )
+					return 0;
+			}
+		}
+	};
+
+	//---------------------------------------------------------------------------
+
+	/* Edit operations and matching blocks, as in python-Levenshtein */
+	enum LevEditType
+	{
+		LEV_EDIT_KEEP,
+		LEV_EDIT_REPLACE,
+		LEV_EDIT_INSERT,
+		LEV_EDIT_DELETE
+	};
+
+	struct LevEditOp
+	{
+		LevEditType type;
+		size_t      spos;   /* source position */
+		size_t      dpos;   /* destination position */
+	};
+
+	struct LevMatchingBlock
+	{
+		size_t spos;
+		size_t dpos;
+		size_t len;
+	};
+
+	//---------------------------------------------------------------------------
+
+	/* Working memory of the distance functions. The buffers only grow, so
+	*   passing the same scratch to every call keeps steady-state scoring off
+	*   the allocator. The overloads without one use lev_thread_scratch().
+	*/
+	struct LevScratch
+	{
+		BlockPatternMatchVector        PM;
+		std::vector<uint64_t>          words;
+		std::vector<size_t>            row;
+		std::vector<LevEditOp>         ops;
+		std::vector<LevMatchingBlock>  blocks;
+		std::vector<uint64_t>          lanes;
+	};
+
+	LevScratch& lev_thread_scratch ( void );
+
+	//---------------------------------------------------------------------------
+
+	/* Edit distance between string1 and string2. xcost == 0 computes the
+	*   Levenshtein distance, otherwise substitutions cost 2 (Indel distance).
+	*   Dispatches to the bit-parallel kernels below.
+	*/
+	size_t lev_edit_distance    ( size_t len1  , const char* string1,
+								  size_t len2  , const char* string2,
+								  int    xcost );
+
+	size_t lev_edit_distance    ( size_t len1  , const char* string1,
+								  size_t len2  , const char* string2,
+								  int    xcost , LevScratch& scratch );
+
+	/* Same as above, but gives up once the distance is known to exceed max:
+	*   returns the distance when it is <= max and max + 1 otherwise
+	*/
+	size_t lev_edit_distance    ( size_t len1  , const char* string1,
+								  size_t len2  , const char* string2,
+								  int    xcost , size_t max );
+
+	size_t lev_edit_distance    ( size_t len1  , const char* string1,
+								  size_t len2  , const char* string2,
+								  int    xcost , size_t max ,
+								  LevScratch& scratch );
+
+	/* lev_edit_distance between string1 and each of strings[0 .. count), of
+	*   lengths lens, into dist. Strings of at most 64 bytes are grouped by
+	*   the narrowest of 8, 16, 32 or 64 bits that holds them and scored a
+	*   vector at a time, one string per lane (16 to 64 strings of 8 bytes
+	*   with SSE2, AVX2 or AVX-512BW), longer ones one at a time.
+	*/
+	void   lev_edit_distance_many ( size_t len1  , const char* string1,
+								   size_t count , const char* const* strings , const size_t* lens ,
+								   int    xcost , size_t* dist );
+
+	void   lev_edit_distance_many ( size_t len1  , const char* string1,
+								   size_t count , const char* const* strings , const size_t* lens ,
+								   int    xcost , size_t* dist , LevScratch& scratch );
+
+	/* Scalar single-row dynamic programming version of lev_edit_distance */
+	size_t lev_edit_distance_dp ( size_t len1  , const char* string1,
+								  size_t len2  , const char* string2,
+								  int    xcost );
+
+	/* Single-row dynamic programming restricted to the diagonals that a path
+	*   of cost <= max can use, with the same return convention as above
+	*/
+	size_t lev_edit_distance_banded ( size_t len1  , const char* string1,
+									  size_t len2  , const char* string2,
+									  int    xcost , size_t max );
+
+	size_t lev_edit_distance_banded ( size_t len1  , const char* string1,
+									  size_t len2  , const char* string2,
+									  int    xcost , size_t max ,
+									  LevScratch& scratch );
+
+	/* Bit-parallel distance between the pattern stored in PM and string2:
+	*   Myers/Hyyro for xcost == 0, Hyyro's LCS for xcost != 0
+	*/
+	size_t lev_bitpal_distance  ( const PatternMatchVector&      PM,
+								  size_t len2  , const char* string2,
+								  int    xcost );
+
+	size_t lev_bitpal_distance  ( const BlockPatternMatchVector& PM,
+								  size_t len2  , const char* string2,
+								  int    xcost );
+
+	size_t lev_bitpal_distance  ( const BlockPatternMatchVector& PM,
+								  size_t len2  , const char* string2,
+								  int    xcost , LevScratch& scratch );
+
+	/* Levenshtein edit operations turning string1 into string2, picked from
+	*   the cost matrix in the same order as python-Levenshtein's editops().
+	*   The matrix is kept as the bit-parallel columns, only the diagonal band
+	*   that optimal paths can cross: about 2 * ( d / 64 + 2 ) words for each
+	*   of the len2 columns, d the distance, so the scratch memory grows with
+	*   len2 * d rather than len1 * len2. Columns of up to 256 KB in all are
+	*   kept whole. A band found too narrow for d is computed again.
+	*/
+	void lev_editops_find ( size_t len1  , const char* string1,
+							size_t len2  , const char* string2,
+							std::vector<LevEditOp>& ops );
+
+	void lev_editops_find ( size_t len1  , const char* string1,
+							size_t len2  , const char* string2,
+							std::vector<LevEditOp>& ops , LevScratch& scratch );
+
+	/* Blocks of characters that the edit operations leave untouched */
+	void lev_editops_matching_blocks ( size_t len1 , size_t len2 ,
+									   const std::vector<LevEditOp>& ops ,
+									   std::vector<LevMatchingBlock>& blocks );
+
+	/* Same as python-Levenshtein's matching_blocks(editops(string1, string2)):
+	*   the list ends with the empty block (len1, len2, 0). Uses scratch.ops.
+	*/
+	void lev_matching_blocks ( size_t len1  , const char* string1,
 							   size_t len2  , const char* string2,
-							   int    xcost );
+							   std::vector<LevMatchingBlock>& blocks ,
+							   LevScratch& scratch );
+
+	//---------------------------------------------------------------------------
+
+	/* The same functions on UTF-16 code units and on code points (see
+	*   Unicode.h): a character is one edit whatever its value. Characters
+	*   above 0xff go through the hash map of BlockPatternMatchVector.
+	*/
+
+	size_t lev_edit_distance    ( size_t len1  , const char16_t* string1,
+								  size_t len2  , const char16_t* string2,
+								  int    xcost );
+
+	size_t lev_edit_distance    ( size_t len1  , const char16_t* string1,
+								  size_t len2  , const char16_t* string2,
+								  int    xcost , LevScratch& scratch );
+
+	size_t lev_edit_distance    ( size_t len1  , const char16_t* string1,
+								  size_t len2  , const char16_t* string2,
+								  int    xcost , size_t max );
+
+	size_t lev_edit_distance    ( size_t len1  , const char16_t* string1,
+								  size_t len2  , const char16_t* string2,
+								  int    xcost , size_t max ,
+								  LevScratch& scratch );
+
+	size_t lev_bitpal_distance  ( const BlockPatternMatchVector& PM,
+								  size_t len2  , const char16_t* string2,
+								  int    xcost );
+
+	size_t lev_bitpal_distance  ( const BlockPatternMatchVector& PM,
+								  size_t len2  , const char16_t* string2,
+								  int    xcost , LevScratch& scratch );
+
+	void lev_editops_find ( size_t len1  , const char16_t* string1,
+							size_t len2  , const char16_t* string2,
+							std::vector<LevEditOp>& ops , LevScratch& scratch );
+
+	void lev_matching_blocks ( size_t len1  , const char16_t* string1,
+							   size_t len2  , const char16_t* string2,
+							   std::vector<LevMatchingBlock>& blocks ,
+							   LevScratch& scratch );
+
+	size_t lev_edit_distance    ( size_t len1  , const char32_t* string1,
+								  size_t len2  , const char32_t* string2,
+								  int    xcost );
+
+	size_t lev_edit_distance    ( size_t len1  , const char32_t* string1,
+								  size_t len2  , const char32_t* string2,
+								  int    xcost , LevScratch& scratch );
+
+	size_t lev_edit_distance    ( size_t len1  , const char32_t* string1,
+								  size_t len2  , const char32_t* string2,
+								  int    xcost , size_t max );
+
+	size_t lev_edit_distance    ( size_t len1  , const char32_t* string1,
+								  size_t len2  , const char32_t* string2,
+								  int    xcost , size_t max ,
+								  LevScratch& scratch );
+
+	size_t lev_bitpal_distance  ( const BlockPatternMatchVector& PM,
+								  size_t len2  , const char32_t* string2,
+								  int    xcost );
+
+	size_t lev_bitpal_distance  ( const BlockPatternMatchVector& PM,
+								  size_t len2  , const char32_t* string2,
+								  int    xcost , LevScratch& scratch );
+
+	void lev_editops_find ( size_t len1  , const char32_t* string1,
+							size_t len2  , const char32_t* string2,
+							std::vector<LevEditOp>& ops , LevScratch& scratch );
+
+	void lev_matching_blocks ( size_t len1  , const char32_t* string1,
+							   size_t len2  , const char32_t* string2,
+							   std::vector<LevMatchingBlock>& blocks ,
+							   LevScratch& scratch );
 }
 #endif
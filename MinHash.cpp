@@ -0,0 +1,436 @@
+#include "MinHash.h"
+#include "FuzzyWuzzy.h"
+#include "Tokenizer.h"
+#include <algorithm>
+#include <math.h>
+
+#if defined(__GNUC__) && ( defined(__x86_64__) || defined(__i386__) )
+#define FUZZYWUZZY_X86 1
+#include <immintrin.h>
+#endif
+
+namespace FuzzyWuzzy
+{
+	static const uint32_t MINHASH_MIX = 0x45D9F3B;
+
+	//---------------------------------------------------------------------------
+
+	static inline uint64_t _splitmix64 ( uint64_t& state )
+	{
+		uint64_t z = ( state += 0x9E3779B97F4A7C15ULL );
+
+		z = ( z ^ ( z >> 30 ) ) * 0xBF58476D1CE4E5B9ULL;
+		z = ( z ^ ( z >> 27 ) ) * 0x94D049BB133111EBULL;
+
+		return z ^ ( z >> 31 );
+	}
+
+	static inline uint32_t _code ( char ch )     { return (unsigned char) ch; }
+	static inline uint32_t _code ( char32_t ch ) { return ch; }
+
+	/* FNV-1a of the token folded to 32 bits */
+	template <typename CharT>
+	static inline uint32_t _token_hash ( const CharT* str , size_t len )
+	{
+		uint64_t h = 0xcbf29ce484222325ULL;
+
+		for ( size_t i = 0 ; i < len ; i++ )
+		{
+			h ^= _code ( str[i] );
+			h *= 0x100000001b3ULL;
+		}
+
+		return (uint32_t) ( h ^ ( h >> 32 ) );
+	}
+
+	//---------------------------------------------------------------------------
+
+	/* image of token x under hash function ( mul , add ) */
+	static inline uint32_t _permute ( uint32_t mul , uint32_t add , uint32_t x )
+	{
+		uint32_t h = mul * x + add;
+
+		h ^= h >> 16;
+
+		return h * MINHASH_MIX;
+	}
+
+	static void _minhash_scalar ( const uint32_t* mul , const uint32_t* add , size_t begin , size_t size ,
+								  const uint32_t* tokens , size_t count , uint32_t* signature )
+	{
+		for ( size_t i = begin ; i < size ; i++ )
+		{
+			uint32_t m = UINT32_MAX;
+
+			for ( size_t t = 0 ; t < count ; t++ )
+				m = std::min ( m , _permute ( mul[i] , add[i] , tokens[t] ) );
+
+			signature[i] = m;
+		}
+	}
+
+	//---------------------------------------------------------------------------
+
+#ifdef FUZZYWUZZY_X86
+
+	__attribute__((target("sse4.1")))
+	static void _minhash_sse41 ( const uint32_t* mul , const uint32_t* add , size_t size ,
+								 const uint32_t* tokens , size_t count , uint32_t* signature )
+	{
+		const __m128i mix = _mm_set1_epi32 ( (int) MINHASH_MIX );
+		size_t        i   = 0;
+
+		for ( ; i + 4 <= size ; i += 4 )
+		{
+			__m128i a = _mm_loadu_si128 ( (const __m128i*) ( mul + i ) );
+			__m128i b = _mm_loadu_si128 ( (const __m128i*) ( add + i ) );
+			__m128i m = _mm_set1_epi32 ( -1 );
+
+			for ( size_t t = 0 ; t < count ; t++ )
+			{
+				__m128i h = _mm_add_epi32 ( _mm_mullo_epi32 ( a , _mm_set1_epi32 ( (int) tokens[t] ) ) , b );
+
+				h = _mm_xor_si128 ( h , _mm_srli_epi32 ( h , 16 ) );
+				m = _mm_min_epu32 ( m , _mm_mullo_epi32 ( h , mix ) );
+			}
+
+			_mm_storeu_si128 ( (__m128i*) ( signature + i ) , m );
+		}
+
+		_minhash_scalar ( mul , add , i , size , tokens , count , signature );
+	}
+
+	__attribute__((target("avx2")))
+	static void _minhash_avx2 ( const uint32_t* mul , const uint32_t* add , size_t size ,
+								const uint32_t* tokens , size_t count , uint32_t* signature )
+	{
+		const __m256i mix = _mm256_set1_epi32 ( (int) MINHASH_MIX );
+		size_t        i   = 0;
+
+		for ( ; i + 8 <= size ; i += 8 )
+		{
+			__m256i a = _mm256_loadu_si256 ( (const __m256i*) ( mul + i ) );
+			__m256i b = _mm256_loadu_si256 ( (const __m256i*) ( add + i ) );
+			__m256i m = _mm256_set1_epi32 ( -1 );
+
+			for ( size_t t = 0 ; t < count ; t++ )
+			{
+				__m256i h = _mm256_add_epi32 ( _mm256_mullo_epi32 ( a , _mm256_set1_epi32 ( (int) tokens[t] ) ) , b );
+
+				h = _mm256_xor_si256 ( h , _mm256_srli_epi32 ( h , 16 ) );
+				m = _mm256_min_epu32 ( m , _mm256_mullo_epi32 ( h , mix ) );
+			}
+
+			_mm256_storeu_si256 ( (__m256i*) ( signature + i ) , m );
+		}
+
+		_minhash_scalar ( mul , add , i , size , tokens , count , signature );
+	}
+
+#endif
+
+	//---------------------------------------------------------------------------
+
+	typedef void (*MinHashKernel) ( const uint32_t* , const uint32_t* , size_t , const uint32_t* , size_t , uint32_t* );
+
+	static void _minhash_generic ( const uint32_t* mul , const uint32_t* add , size_t size ,
+								   const uint32_t* tokens , size_t count , uint32_t* signature )
+	{
+		_minhash_scalar ( mul , add , 0 , size , tokens , count , signature );
+	}
+
+	/* picks the widest kernel the CPU supports, once */
+	static MinHashKernel _minhash_kernel ( void )
+	{
+#ifdef FUZZYWUZZY_X86
+		static const MinHashKernel kernel = __builtin_cpu_supports ( "avx2" )   ? _minhash_avx2  :
+											__builtin_cpu_supports ( "sse4.1" ) ? _minhash_sse41 :
+																				  _minhash_generic;
+		return kernel;
+#else
+		return _minhash_generic;
+#endif
+	}
+
+	//---------------------------------------------------------------------------
+
+	MinHash::MinHash ( size_t size , uint64_t seed ) :
+		_mul ( size ) ,
+		_add ( size )
+	{
+		for ( size_t i = 0 ; i < size ; i++ )
+		{
+			_mul[i] = (uint32_t) _splitmix64 ( seed ) | 1;
+			_add[i] = (uint32_t) _splitmix64 ( seed );
+		}
+	}
+
+	//---------------------------------------------------------------------------
+
+	template <typename CharT>
+	void MinHash::_signature ( const std::basic_string<CharT>& s , uint32_t* signature ) const
+	{
+		static thread_local std::vector<TokenSpan> spans;
+		static thread_local std::vector<uint32_t>  tokens;
+
+		find_tokens ( s.data() , s.length() , spans );
+
+		// repeated tokens do not change the minimum, only drop them cheaply
+		tokens.clear();
+
+		for ( std::vector<TokenSpan>::const_iterator it = spans.begin(); it != spans.end(); ++it )
+			tokens.push_back ( _token_hash ( s.data() + it->offset , it->length ) );
+
+		std::sort ( tokens.begin() , tokens.end() );
+		tokens.erase ( std::unique ( tokens.begin() , tokens.end() ) , tokens.end() );
+
+		_minhash_kernel() ( _mul.data() , _add.data() , size() , tokens.data() , tokens.size() , signature );
+	}
+
+	template <typename String>
+	void MinHash::_signatures ( ThreadPool& pool , const std::vector<String>& choices ,
+								std::vector<uint32_t>& signatures ) const
+	{
+		const size_t CHUNK = 256;
+
+		signatures.resize ( choices.size() * size() );
+
+		pool.parallel_for ( ( choices.size() + CHUNK - 1 ) / CHUNK , [&] ( size_t chunk , size_t )
+		{
+			size_t end = std::min ( choices.size() , ( chunk + 1 ) * CHUNK );
+
+			for ( size_t id = chunk * CHUNK ; id < end ; id++ )
+				_signature ( choices[id] , signatures.data() + id * size() );
+		});
+	}
+
+	void MinHash::signature ( const std::string& s , uint32_t* signature ) const
+	{
+		_signature ( s , signature );
+	}
+
+	void MinHash::signature ( const std::u32string& s , uint32_t* signature ) const
+	{
+		_signature ( s , signature );
+	}
+
+	void MinHash::signatures ( ThreadPool& pool , const std::vector<std::string>& choices ,
+							   std::vector<uint32_t>& signatures ) const
+	{
+		_signatures ( pool , choices , signatures );
+	}
+
+	void MinHash::signatures ( ThreadPool& pool , const std::vector<std::u32string>& choices ,
+							   std::vector<uint32_t>& signatures ) const
+	{
+		_signatures ( pool , choices , signatures );
+	}
+
+	//---------------------------------------------------------------------------
+
+	MinHashLSH::MinHashLSH ( size_t bands , size_t rows , size_t shard , size_t shard_count , uint64_t seed ) :
+		_hasher      ( bands * rows , seed ) ,
+		_bands       ( bands ) ,
+		_rows        ( rows ) ,
+		_shard       ( shard ) ,
+		_shard_count ( std::max ( shard_count , (size_t) 1 ) ) ,
+		_built       ( true )
+	{
+	}
+
+	//---------------------------------------------------------------------------
+
+	uint64_t MinHashLSH::_band_key ( size_t band , const uint32_t* signature ) const
+	{
+		uint64_t key = 0x9E3779B97F4A7C15ULL * ( band + 1 );
+
+		for ( size_t r = 0 ; r < _rows ; r++ )
+		{
+			key ^= signature[band * _rows + r];
+			key *= 0xFF51AFD7ED558CCDULL;
+			key ^= key >> 32;
+		}
+
+		return key;
+	}
+
+	//---------------------------------------------------------------------------
+
+	void MinHashLSH::add ( uint32_t id , const uint32_t* signature )
+	{
+		for ( size_t band = 0 ; band < _bands ; band++ )
+		{
+			uint64_t key = _band_key ( band , signature );
+
+			if ( _in_shard ( key ) )
+				_entries.push_back ( { key , id } );
+		}
+
+		_built = false;
+	}
+
+	void MinHashLSH::add ( uint32_t id , const std::string& s )
+	{
+		static thread_local std::vector<uint32_t> signature;
+
+		signature.resize ( _hasher.size() );
+		_hasher.signature ( s , signature.data() );
+
+		add ( id , signature.data() );
+	}
+
+	void MinHashLSH::add ( uint32_t id , const std::u32string& s )
+	{
+		static thread_local std::vector<uint32_t> signature;
+
+		signature.resize ( _hasher.size() );
+		_hasher.signature ( s , signature.data() );
+
+		add ( id , signature.data() );
+	}
+
+	void MinHashLSH::build ( void )
+	{
+		if ( _built )
+			return;
+
+		std::sort ( _entries.begin() , _entries.end() , [] ( const Entry& a , const Entry& b )
+		{
+			return a.key != b.key ? a.key < b.key : a.id < b.id;
+		});
+
+		_built = true;
+	}
+
+	//---------------------------------------------------------------------------
+
+	void MinHashLSH::candidates ( const uint32_t* signature , std::vector<uint32_t>& ids ) const
+	{
+		ids.clear();
+
+		for ( size_t band = 0 ; band < _bands ; band++ )
+		{
+			uint64_t key = _band_key ( band , signature );
+
+			if ( !_in_shard ( key ) )
+				continue;
+
+			std::vector<Entry>::const_iterator it = std::lower_bound ( _entries.begin() , _entries.end() , key ,
+				[] ( const Entry& e , uint64_t k ) { return e.key < k; } );
+
+			for ( ; it != _entries.end() && it->key == key ; ++it )
+				ids.push_back ( it->id );
+		}
+
+		std::sort ( ids.begin() , ids.end() );
+		ids.erase ( std::unique ( ids.begin() , ids.end() ) , ids.end() );
+	}
+
+	//---------------------------------------------------------------------------
+
+	void MinHashLSH::candidate_pairs ( std::vector< std::pair<uint32_t,uint32_t> >& pairs ) const
+	{
+		pairs.clear();
+
+		for ( size_t begin = 0 , end ; begin < _entries.size() ; begin = end )
+		{
+			for ( end = begin + 1 ; end < _entries.size() && _entries[end].key == _entries[begin].key ; end++ )
+				;
+
+			// the ids of a bucket are sorted
+			for ( size_t i = begin ; i < end ; i++ )
+				for ( size_t j = i + 1 ; j < end ; j++ )
+					if ( _entries[i].id != _entries[j].id )
+						pairs.push_back ( std::make_pair ( _entries[i].id , _entries[j].id ) );
+		}
+
+		std::sort ( pairs.begin() , pairs.end() );
+		pairs.erase ( std::unique ( pairs.begin() , pairs.end() ) , pairs.end() );
+	}
+
+	//---------------------------------------------------------------------------
+
+	double MinHashLSH::collision_probability ( double s , size_t bands , size_t rows )
+	{
+		return 1.0 - pow ( 1.0 - pow ( s , (double) rows ) , (double) bands );
+	}
+
+	//---------------------------------------------------------------------------
+
+	/* verifies pairs[begin, end), one cached scorer per run of equal firsts */
+	template <typename CachedScorer , typename String>
+	static void _verify_range ( const std::vector<String>& choices ,
+								const std::vector< std::pair<uint32_t,uint32_t> >& pairs ,
+								size_t begin , size_t end , double score_cutoff ,
+								std::vector<ScoredPair>& matches )
+	{
+		while ( begin < end )
+		{
+			uint32_t     first = pairs[begin].first;
+			CachedScorer scorer ( choices[first] );
+
+			for ( ; begin < end && pairs[begin].first == first ; begin++ )
+			{
+				uint32_t second = pairs[begin].second;
+				double   score  = scorer.similarity ( choices[second] , score_cutoff );
+
+				if ( score >= score_cutoff )
+					matches.push_back ( { first , second , score } );
+			}
+		}
+	}
+
+	template <typename CachedScorer , typename String>
+	static void _verify_pairs ( ThreadPool& pool , const std::vector<String>& choices ,
+								const std::vector< std::pair<uint32_t,uint32_t> >& pairs ,
+								double score_cutoff , std::vector<ScoredPair>& matches )
+	{
+		const size_t CHUNK = 4096;
+
+		size_t                               chunks = ( pairs.size() + CHUNK - 1 ) / CHUNK;
+		std::vector< std::vector<ScoredPair> > found ( chunks );
+
+		pool.parallel_for ( chunks , [&] ( size_t chunk , size_t )
+		{
+			_verify_range<CachedScorer> ( choices , pairs , chunk * CHUNK , std::min ( pairs.size() , ( chunk + 1 ) * CHUNK ) ,
+										  score_cutoff , found[chunk] );
+		});
+
+		matches.clear();
+
+		for ( const std::vector<ScoredPair>& part : found )
+			matches.insert ( matches.end() , part.begin() , part.end() );
+	}
+
+	void verify_pairs ( const std::vector<std::string>& choices ,
+						const std::vector< std::pair<uint32_t,uint32_t> >& pairs ,
+						double score_cutoff , std::vector<ScoredPair>& matches )
+	{
+		matches.clear();
+
+		_verify_range<CachedTokenSetRatio> ( choices , pairs , 0 , pairs.size() , score_cutoff , matches );
+	}
+
+	void verify_pairs ( ThreadPool& pool , const std::vector<std::string>& choices ,
+						const std::vector< std::pair<uint32_t,uint32_t> >& pairs ,
+						double score_cutoff , std::vector<ScoredPair>& matches )
+	{
+		_verify_pairs<CachedTokenSetRatio> ( pool , choices , pairs , score_cutoff , matches );
+	}
+
+	void verify_pairs ( const std::vector<std::u32string>& choices ,
+						const std::vector< std::pair<uint32_t,uint32_t> >& pairs ,
+						double score_cutoff , std::vector<ScoredPair>& matches )
+	{
+		matches.clear();
+
+		_verify_range<U32CachedTokenSetRatio> ( choices , pairs , 0 , pairs.size() , score_cutoff , matches );
+	}
+
+	void verify_pairs ( ThreadPool& pool , const std::vector<std::u32string>& choices ,
+						const std::vector< std::pair<uint32_t,uint32_t> >& pairs ,
+						double score_cutoff , std::vector<ScoredPair>& matches )
+	{
+		_verify_pairs<U32CachedTokenSetRatio> ( pool , choices , pairs , score_cutoff , matches );
+	}
+}
@@ -0,0 +1,149 @@
+#ifndef MinHashH
+#define MinHashH
+
+#include "ThreadPool.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace FuzzyWuzzy
+{
+	/* MinHash signatures of token sets (see find_tokens): value i of the
+	*   signature is the smallest image of the tokens under the i-th hash
+	*   function, so two sets agree on a value with a probability equal to
+	*   their Jaccard similarity. Every token is hashed once, then all the
+	*   functions run on it 8 or 4 at a time with AVX2 or SSE4.1 when the CPU
+	*   has it. A string without tokens has the signature of all UINT32_MAX.
+	*
+	*   The std::u32string overloads take the tokens of code points, those of
+	*   token_set_ratio on std::u32string (utf8_decode turns UTF-8 into them):
+	*   on bytes, letters above ASCII split tokens.
+	*/
+	class MinHash
+	{
+	private :
+
+		std::vector<uint32_t> _mul;   /* odd */
+		std::vector<uint32_t> _add;
+
+		template <typename CharT>
+		void _signature  ( const std::basic_string<CharT>& s , uint32_t* signature ) const;
+		template <typename String>
+		void _signatures ( ThreadPool& pool , const std::vector<String>& choices ,
+						   std::vector<uint32_t>& signatures ) const;
+
+	public:
+
+		// size hash functions, drawn from seed
+		MinHash ( size_t size , uint64_t seed = 0 );
+
+		size_t size ( void ) const { return _mul.size(); }
+
+		/* the size() values of the signature of s into signature */
+		void signature ( const std::string&    s , uint32_t* signature ) const;
+		void signature ( const std::u32string& s , uint32_t* signature ) const;
+
+		/* The signatures of all choices, one row of size() values per choice,
+		*   computed on the threads of pool
+		*/
+		void signatures ( ThreadPool& pool , const std::vector<std::string>& choices ,
+						  std::vector<uint32_t>& signatures ) const;
+		void signatures ( ThreadPool& pool , const std::vector<std::u32string>& choices ,
+						  std::vector<uint32_t>& signatures ) const;
+	};
+
+	//---------------------------------------------------------------------------
+
+	/* Banded locality sensitive hashing of MinHash signatures of bands * rows
+	*   values: two strings become a candidate pair when all the rows of one
+	*   of their bands agree, which for token sets of Jaccard similarity s
+	*   happens with probability 1 - ( 1 - s^rows )^bands. More rows make the
+	*   pairs more precise, more bands find more of them.
+	*
+	*   A table holds the buckets of the band keys that hash to its shard out
+	*   of shard_count, so the shards of one data set can be built and paired
+	*   independently, on different threads or machines, and their pairs
+	*   merged. add() collects the buckets, build() sorts them: queries and
+	*   pairs need a table built since the last add().
+	*/
+	class MinHashLSH
+	{
+	private :
+
+		struct Entry
+		{
+			uint64_t key;   /* the band and its rows */
+			uint32_t id;
+		};
+
+		MinHash            _hasher;
+		size_t             _bands , _rows;
+		size_t             _shard , _shard_count;
+		std::vector<Entry> _entries;
+		bool               _built;
+
+		uint64_t _band_key ( size_t band , const uint32_t* signature ) const;
+		bool     _in_shard ( uint64_t key ) const { return key % _shard_count == _shard; }
+
+	public:
+
+		MinHashLSH ( size_t bands , size_t rows , size_t shard = 0 , size_t shard_count = 1 , uint64_t seed = 0 );
+
+		// the signatures the table expects, of bands * rows values
+		const MinHash& hasher ( void ) const { return _hasher; }
+
+		size_t bands ( void ) const { return _bands; }
+		size_t rows  ( void ) const { return _rows;  }
+
+		/* Adds id with its signature, or the string s */
+		void add ( uint32_t id , const uint32_t* signature );
+		void add ( uint32_t id , const std::string&    s );
+		void add ( uint32_t id , const std::u32string& s );
+
+		void build ( void );
+
+		/* The ids sharing a bucket with signature, increasing */
+		void candidates ( const uint32_t* signature , std::vector<uint32_t>& ids ) const;
+
+		/* Every pair of ids sharing a bucket of this shard, the smaller id
+		*   first, sorted. Large buckets give many pairs: there the bands are
+		*   too short.
+		*/
+		void candidate_pairs ( std::vector< std::pair<uint32_t,uint32_t> >& pairs ) const;
+
+		/* probability that token sets of Jaccard similarity s share a bucket */
+		static double collision_probability ( double s , size_t bands , size_t rows );
+	};
+
+	//---------------------------------------------------------------------------
+
+	struct ScoredPair
+	{
+		uint32_t first , second;
+		double   score;
+	};
+
+	/* The candidate pairs (sorted, as candidate_pairs gives them) of choices
+	*   whose token_set_ratio reaches score_cutoff, with their score. The pool
+	*   overloads split the pairs between their threads and keep their order.
+	*/
+	void verify_pairs ( const std::vector<std::string>& choices ,
+						const std::vector< std::pair<uint32_t,uint32_t> >& pairs ,
+						double score_cutoff , std::vector<ScoredPair>& matches );
+
+	void verify_pairs ( ThreadPool& pool , const std::vector<std::string>& choices ,
+						const std::vector< std::pair<uint32_t,uint32_t> >& pairs ,
+						double score_cutoff , std::vector<ScoredPair>& matches );
+
+	void verify_pairs ( const std::vector<std::u32string>& choices ,
+						const std::vector< std::pair<uint32_t,uint32_t> >& pairs ,
+						double score_cutoff , std::vector<ScoredPair>& matches );
+
+	void verify_pairs ( ThreadPool& pool , const std::vector<std::u32string>& choices ,
+						const std::vector< std::pair<uint32_t,uint32_t> >& pairs ,
+						double score_cutoff , std::vector<ScoredPair>& matches );
+}
+
+#endif
@@ -0,0 +1,776 @@
+/**
+* Python fuzzywuzzy's process module: match one query against many choices
+* @see https://github.com/seatgeek/fuzzywuzzy/blob/master/fuzzywuzzy/process.py
+*/
+
+#ifndef ProcessH
+#define ProcessH
+
+#include "FuzzyWuzzy.h"
+#include "QGramIndex.h"
+#include "ThreadPool.h"
+#include "TokenIndex.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace FuzzyWuzzy
+{
+namespace process
+{
+	//###########################
+	//# Scorers and Processors  #
+	//###########################
+
+	// A scorer is either
+	//   Cached<CachedScorer>()    the query is preprocessed once into a
+	//                             CachedScorer (see FuzzyWuzzy.h)
+	//   any callable              double ( query , choice ) or
+	//                             double ( query , choice , score_cutoff )
+	// Overloaded functions such as ratio must be wrapped in a lambda.
+	//
+	// A processor is a callable std::string ( const std::string& ) applied to
+	// the query and to every choice before scoring, or no_process.
+
+	template <typename CachedScorer>
+	struct Cached {};
+
+	struct NoProcess {};
+
+	const NoProcess no_process = NoProcess();
+
+	typedef std::string (*Processor) ( const std::string& );
+
+	//---------------------------------------------------------------------------
+
+	// Key is the index of the choice for plain ranges of strings, and the key
+	// of the pair for ranges of key/value pairs (std::map, vector of pairs...)
+
+	template <typename Key>
+	struct ExtractResult
+	{
+		std::string choice;
+		double      score;
+		Key         key;
+	};
+
+	//---------------------------------------------------------------------------
+	// Implementation details
+	//---------------------------------------------------------------------------
+
+	template <typename T>
+	struct _is_pair : std::false_type {};
+
+	template <typename K , typename V>
+	struct _is_pair< std::pair<K,V> > : std::true_type {};
+
+	template <typename Range>
+	using _element_t = typename std::decay<decltype ( *std::begin ( std::declval<const Range&>() ) )>::type;
+
+	template <typename Element , bool = _is_pair<Element>::value>
+	struct _choice_traits
+	{
+		typedef size_t key_type;
+
+		static const Element& choice ( const Element& e )            { return e; }
+		static key_type       key    ( const Element& , size_t idx ) { return idx; }
+	};
+
+	template <typename Element>
+	struct _choice_traits<Element , true>
+	{
+		typedef typename std::remove_const<typename Element::first_type>::type key_type;
+
+		static const typename Element::second_type& choice ( const Element& e )            { return e.second; }
+		static key_type                              key    ( const Element& e , size_t ) { return e.first; }
+	};
+
+	template <typename Range>
+	using _traits_t = _choice_traits< _element_t<Range> >;
+
+	template <typename Range>
+	using _result_t = ExtractResult< typename _traits_t<Range>::key_type >;
+
+	//---------------------------------------------------------------------------
+
+	// scorers bound to one query: double ( choice , score_cutoff )
+
+	template <typename CachedScorer>
+	class _BoundCached
+	{
+	private :
+
+		CachedScorer _cached;
+
+	public:
+
+		_BoundCached ( const std::string& query ) : _cached ( query ) {}
+
+		double operator() ( const std::string& choice , double score_cutoff ) const
+		{
+			return _cached.similarity ( choice , score_cutoff );
+		}
+	};
+
+	template <typename Scorer>
+	class _BoundFunction
+	{
+	private :
+
+		Scorer      _scorer;
+		std::string _query;
+
+	public:
+
+		_BoundFunction ( const Scorer& scorer , const std::string& query ) : _scorer ( scorer ) , _query ( query ) {}
+
+		double operator() ( const std::string& choice , double score_cutoff ) const
+		{
+			if constexpr ( std::is_invocable_r<double , const Scorer& , const std::string& , const std::string& , double>::value )
+			{
+				return _scorer ( _query , choice , score_cutoff );
+			}
+			else
+			{
+				double score = _scorer ( _query , choice );
+				return score >= score_cutoff ? score : 0;
+			}
+		}
+	};
+
+	template <typename CachedScorer>
+	_BoundCached<CachedScorer> _bind ( const Cached<CachedScorer>& , const std::string& query )
+	{
+		return _BoundCached<CachedScorer> ( query );
+	}
+
+	template <typename Scorer>
+	_BoundFunction<Scorer> _bind ( const Scorer& scorer , const std::string& query )
+	{
+		return _BoundFunction<Scorer> ( scorer , query );
+	}
+
+	//---------------------------------------------------------------------------
+
+	inline std::string _apply ( const NoProcess& , const std::string& s )
+	{
+		return s;
+	}
+
+	template <typename Proc>
+	std::string _apply ( const Proc& processor , const std::string& s )
+	{
+		return processor ( s );
+	}
+
+	/* calls f ( processed choice ) without copying when nothing is processed */
+	template <typename Proc , typename F>
+	double _score_processed ( const Proc& processor , const std::string& choice , F f )
+	{
+		if constexpr ( std::is_same<Proc , NoProcess>::value )
+			return f ( choice );
+		else
+			return f ( processor ( choice ) );
+	}
+
+	//---------------------------------------------------------------------------
+
+	/* ordering of the top-k heap: better scores first, earlier choices on ties */
+	template <typename Result>
+	struct _Candidate
+	{
+		Result result;
+		size_t index;
+
+		bool operator< ( const _Candidate& other ) const
+		{
+			if ( result.score != other.result.score )
+				return result.score > other.result.score;
+
+			return index < other.index;
+		}
+	};
+
+	//###############
+	//# Extraction  #
+	//###############
+
+	/* Every choice scoring at least score_cutoff, in the order of choices */
+	template <typename Range , typename Scorer = Cached<CachedWRatio> , typename Proc = Processor>
+	std::vector< _result_t<Range> > extractWithoutOrder ( const std::string& query     , const Range& choices ,
+														  Scorer             scorer    = Scorer() ,
+														  Proc               processor = full_process ,
+														  double             score_cutoff = 0 )
+	{
+		typedef _traits_t<Range> traits;
+
+		std::vector< _result_t<Range> > results;
+
+		auto   scored = _bind ( scorer , _apply ( processor , query ) );
+		size_t idx    = 0;
+
+		for ( const auto& element : choices )
+		{
+			const std::string& choice = traits::choice ( element );
+
+			double score = _score_processed ( processor , choice , [&] ( const std::string& c )
+			{
+				return scored ( c , score_cutoff );
+			});
+
+			if ( score >= score_cutoff )
+				results.push_back ( { choice , score , traits::key ( element , idx ) } );
+
+			++idx;
+		}
+
+		return results;
+	}
+
+	//---------------------------------------------------------------------------
+
+	/* The limit best choices scoring at least score_cutoff, best first
+	*   (limit == 0 returns all of them). Once limit candidates are kept, the
+	*   worst of them becomes the cutoff for the remaining choices.
+	*/
+	template <typename Range , typename Scorer = Cached<CachedWRatio> , typename Proc = Processor>
+	std::vector< _result_t<Range> > extractBests ( const std::string& query        , const Range& choices ,
+												   Scorer             scorer       = Scorer() ,
+												   Proc               processor    = full_process ,
+												   double             score_cutoff = 0 ,
+												   size_t             limit        = 5 )
+	{
+		typedef _traits_t<Range>             traits;
+		typedef _Candidate< _result_t<Range> > candidate;
+
+		std::vector<candidate> heap;
+
+		auto   scored = _bind ( scorer , _apply ( processor , query ) );
+		size_t idx    = 0;
+		double cutoff = score_cutoff;
+
+		for ( const auto& element : choices )
+		{
+			const std::string& choice = traits::choice ( element );
+
+			double score = _score_processed ( processor , choice , [&] ( const std::string& c )
+			{
+				return scored ( c , cutoff );
+			});
+
+			// heap.front() is the worst kept candidate
+			if ( score >= score_cutoff && ( limit == 0 || heap.size() < limit || score > heap.front().result.score ) )
+			{
+				if ( limit != 0 && heap.size() == limit )
+				{
+					std::pop_heap ( heap.begin() , heap.end() );
+					heap.pop_back();
+				}
+
+				heap.push_back ( { { choice , score , traits::key ( element , idx ) } , idx } );
+				std::push_heap ( heap.begin() , heap.end() );
+
+				if ( limit != 0 && heap.size() == limit )
+					cutoff = std::max ( score_cutoff , heap.front().result.score );
+			}
+
+			++idx;
+		}
+
+		std::sort ( heap.begin() , heap.end() );
+
+		std::vector< _result_t<Range> > results;
+		results.reserve ( heap.size() );
+
+		for ( typename std::vector<candidate>::iterator it = heap.begin(); it != heap.end(); ++it )
+			results.push_back ( it->result );
+
+		return results;
+	}
+
+	//---------------------------------------------------------------------------
+
+	/* The limit best choices, best first */
+	template <typename Range , typename Scorer = Cached<CachedWRatio> , typename Proc = Processor>
+	std::vector< _result_t<Range> > extract ( const std::string& query     , const Range& choices ,
+											  Scorer             scorer    = Scorer() ,
+											  Proc               processor = full_process ,
+											  size_t             limit     = 5 )
+	{
+		return extractBests ( query , choices , scorer , processor , 0 , limit );
+	}
+
+	//---------------------------------------------------------------------------
+
+	/* The best choice scoring at least score_cutoff, the first one on ties */
+	template <typename Range , typename Scorer = Cached<CachedWRatio> , typename Proc = Processor>
+	std::optional< _result_t<Range> > extractOne ( const std::string& query        , const Range& choices ,
+												   Scorer             scorer       = Scorer() ,
+												   Proc               processor    = full_process ,
+												   double             score_cutoff = 0 )
+	{
+		std::vector< _result_t<Range> > best = extractBests ( query , choices , scorer , processor , score_cutoff , 1 );
+
+		if ( best.empty() )
+			return std::nullopt;
+
+		return best.front();
+	}
+
+	//########################
+	//# Indexed Extraction   #
+	//########################
+
+	// Same results as extractBests and extractOne over index.choice ( 0 .. ),
+	// keyed by id, scoring only the candidates of an index. The query and the
+	// choices are scored as they are, without processor.
+	//
+	// QGramIndex (see QGramIndex.h) filters for ratio and partial_ratio,
+	// TokenIndex (see TokenIndex.h) for token_set_ratio. Neither drops a
+	// choice that reaches score_cutoff.
+
+	/* extractBests over the choices listed in ids, in increasing order */
+	template <typename CachedScorer>
+	std::vector< ExtractResult<size_t> > _extract_ids ( const std::vector<std::string>& choices      ,
+														const std::vector<uint32_t>&    ids          ,
+														const std::string&              query        ,
+														Cached<CachedScorer>            scorer       ,
+														double                          score_cutoff ,
+														size_t                          limit        )
+	{
+		// nothing filtered out, a plain scan is cheaper
+		if ( ids.size() == choices.size() )
+			return extractBests ( query , choices , scorer , no_process , score_cutoff , limit );
+
+		std::vector< std::pair< size_t , std::reference_wrapper<const std::string> > > candidates;
+		candidates.reserve ( ids.size() );
+
+		for ( uint32_t id : ids )
+			candidates.emplace_back ( id , std::cref ( choices[id] ) );
+
+		return extractBests ( query , candidates , scorer , no_process , score_cutoff , limit );
+	}
+
+	//---------------------------------------------------------------------------
+
+	template <typename CachedScorer = CachedRatio>
+	std::vector< ExtractResult<size_t> > extractBests ( const QGramIndex&    index        ,
+														const std::string&   query        ,
+														Cached<CachedScorer> scorer       = Cached<CachedScorer>() ,
+														double               score_cutoff = 0 ,
+														size_t               limit        = 5 )
+	{
+		static_assert ( std::is_same<CachedScorer,CachedRatio>::value || std::is_same<CachedScorer,CachedPartialRatio>::value ,
+						"the q-gram index only filters for ratio and partial_ratio" );
+
+		static thread_local std::vector<uint32_t> ids;
+
+		index.candidates ( query , score_cutoff , std::is_same<CachedScorer,CachedPartialRatio>::value , ids );
+
+		return _extract_ids ( index.choices() , ids , query , scorer , score_cutoff , limit );
+	}
+
+	template <typename CachedScorer = CachedTokenSetRatio>
+	std::vector< ExtractResult<size_t> > extractBests ( const TokenIndex&    index        ,
+														const std::string&   query        ,
+														Cached<CachedScorer> scorer       = Cached<CachedScorer>() ,
+														double               score_cutoff = 0 ,
+														size_t               limit        = 5 )
+	{
+		static_assert ( std::is_same<CachedScorer,CachedTokenSetRatio>::value ,
+						"the token index only filters for token_set_ratio" );
+
+		static thread_local std::vector<uint32_t> ids;
+
+		index.candidates ( query , score_cutoff , ids );
+
+		return _extract_ids ( index.choices() , ids , query , scorer , score_cutoff , limit );
+	}
+
+	//---------------------------------------------------------------------------
+
+	template <typename CachedScorer = CachedRatio>
+	std::optional< ExtractResult<size_t> > extractOne ( const QGramIndex&    index        ,
+														const std::string&   query        ,
+														Cached<CachedScorer> scorer       = Cached<CachedScorer>() ,
+														double               score_cutoff = 0 )
+	{
+		std::vector< ExtractResult<size_t> > best = extractBests ( index , query , scorer , score_cutoff , 1 );
+
+		if ( best.empty() )
+			return std::nullopt;
+
+		return best.front();
+	}
+
+	template <typename CachedScorer = CachedTokenSetRatio>
+	std::optional< ExtractResult<size_t> > extractOne ( const TokenIndex&    index        ,
+														const std::string&   query        ,
+														Cached<CachedScorer> scorer       = Cached<CachedScorer>() ,
+														double               score_cutoff = 0 )
+	{
+		std::vector< ExtractResult<size_t> > best = extractBests ( index , query , scorer , score_cutoff , 1 );
+
+		if ( best.empty() )
+			return std::nullopt;
+
+		return best.front();
+	}
+
+	//########################
+	//# Parallel Extraction  #
+	//########################
+
+	// Same results as the functions above, computed on the threads of pool
+	// (the pool size caps the number of threads). The choices are split in
+	// chunks; every worker keeps its own top-k and binds its own copy of the
+	// scorer. The best worst-of-top-k seen by any worker is shared through an
+	// atomic and used as cutoff by all of them.
+
+	template <typename Range , typename Scorer = Cached<CachedWRatio> , typename Proc = Processor>
+	std::vector< _result_t<Range> > extractBests ( ThreadPool&        pool         ,
+												   const std::string& query        , const Range& choices ,
+												   Scorer             scorer       = Scorer() ,
+												   Proc               processor    = full_process ,
+												   double             score_cutoff = 0 ,
+												   size_t             limit        = 5 )
+	{
+		typedef _traits_t<Range>                                             traits;
+		typedef _element_t<Range>                                            element;
+		typedef _Candidate< _result_t<Range> >                               candidate;
+		typedef decltype ( _bind ( scorer , std::string() ) )                bound;
+		typedef typename std::iterator_traits<decltype ( std::begin ( choices ) )>::iterator_category category;
+
+		const bool random_access = std::is_base_of<std::random_access_iterator_tag , category>::value;
+
+		// ranges without random access are indexed through pointers
+		std::vector<const element*> pointers;
+
+		if constexpr ( !random_access )
+			for ( const auto& e : choices )
+				pointers.push_back ( &e );
+
+		size_t count = random_access ? (size_t) std::distance ( std::begin ( choices ) , std::end ( choices ) ) :
+									   pointers.size();
+
+		struct alignas(64) Worker
+		{
+			std::optional<bound>   scored;
+			std::vector<candidate> heap;
+		};
+
+		std::vector<Worker> workers ( pool.size() );
+		std::atomic<double> shared ( score_cutoff );
+		std::string         processed = _apply ( processor , query );
+
+		size_t chunk  = std::max<size_t> ( 64 , count / ( pool.size() * 16 ) + 1 );
+		size_t chunks = ( count + chunk - 1 ) / chunk;
+
+		pool.parallel_for ( chunks , [&] ( size_t c , size_t w )
+		{
+			Worker& worker = workers[w];
+
+			if ( !worker.scored )
+				worker.scored.emplace ( _bind ( scorer , processed ) );
+
+			for ( size_t idx = c * chunk; idx < std::min ( count , ( c + 1 ) * chunk ); ++idx )
+			{
+				const element* e;
+
+				if constexpr ( random_access )
+					e = &std::begin ( choices )[idx];
+				else
+					e = pointers[idx];
+
+				const std::string& choice = traits::choice ( *e );
+
+				double cutoff = std::max ( score_cutoff , shared.load ( std::memory_order_relaxed ) );
+
+				if ( limit != 0 && worker.heap.size() == limit )
+					cutoff = std::max ( cutoff , worker.heap.front().result.score );
+
+				double score = _score_processed ( processor , choice , [&] ( const std::string& s )
+				{
+					return (*worker.scored) ( s , cutoff );
+				});
+
+				if ( score < cutoff )
+					continue;
+
+				// chunks arrive out of order, so ties are decided on the index
+				candidate cand = { { choice , score , traits::key ( *e , idx ) } , idx };
+
+				if ( limit == 0 || worker.heap.size() < limit )
+				{
+					worker.heap.push_back ( cand );
+					std::push_heap ( worker.heap.begin() , worker.heap.end() );
+				}
+				else if ( cand < worker.heap.front() )
+				{
+					std::pop_heap ( worker.heap.begin() , worker.heap.end() );
+					worker.heap.back() = cand;
+					std::push_heap ( worker.heap.begin() , worker.heap.end() );
+				}
+
+				if ( limit != 0 && worker.heap.size() == limit )
+					atomic_max ( shared , worker.heap.front().result.score );
+			}
+		});
+
+		std::vector<candidate> merged;
+
+		for ( typename std::vector<Worker>::iterator it = workers.begin(); it != workers.end(); ++it )
+			merged.insert ( merged.end() , it->heap.begin() , it->heap.end() );
+
+		std::sort ( merged.begin() , merged.end() );
+
+		if ( limit != 0 && merged.size() > limit )
+			merged.resize ( limit );
+
+		std::vector< _result_t<Range> > results;
+		results.reserve ( merged.size() );
+
+		for ( typename std::vector<candidate>::iterator it = merged.begin(); it != merged.end(); ++it )
+			results.push_back ( it->result );
+
+		return results;
+	}
+
+	//---------------------------------------------------------------------------
+
+	template <typename Range , typename Scorer = Cached<CachedWRatio> , typename Proc = Processor>
+	std::vector< _result_t<Range> > extract ( ThreadPool&        pool      ,
+											  const std::string& query     , const Range& choices ,
+											  Scorer             scorer    = Scorer() ,
+											  Proc               processor = full_process ,
+											  size_t             limit     = 5 )
+	{
+		return extractBests ( pool , query , choices , scorer , processor , 0 , limit );
+	}
+
+	//---------------------------------------------------------------------------
+
+	template <typename Range , typename Scorer = Cached<CachedWRatio> , typename Proc = Processor>
+	std::optional< _result_t<Range> > extractOne ( ThreadPool&        pool         ,
+												   const std::string& query        , const Range& choices ,
+												   Scorer             scorer       = Scorer() ,
+												   Proc               processor    = full_process ,
+												   double             score_cutoff = 0 )
+	{
+		std::vector< _result_t<Range> > best = extractBests ( pool , query , choices , scorer , processor , score_cutoff , 1 );
+
+		if ( best.empty() )
+			return std::nullopt;
+
+		return best.front();
+	}
+
+	//##########################
+	//# All-pairs Score Matrix #
+	//##########################
+
+	/* Dense row-major matrix, one row per query and one column per choice */
+	template <typename T>
+	class Matrix
+	{
+	private :
+
+		size_t         _rows , _cols;
+		std::vector<T> _data;
+
+	public:
+
+		Matrix ( size_t rows , size_t cols ) : _rows ( rows ) , _cols ( cols ) , _data ( rows * cols ) {}
+
+		size_t rows ( void ) const { return _rows; }
+		size_t cols ( void ) const { return _cols; }
+
+		T&       operator() ( size_t row , size_t col )       { return _data[row * _cols + col]; }
+		const T& operator() ( size_t row , size_t col ) const { return _data[row * _cols + col]; }
+
+		T*       data ( void )       { return _data.data(); }
+		const T* data ( void ) const { return _data.data(); }
+	};
+
+	//---------------------------------------------------------------------------
+
+	// how cdist preprocesses the choices for a cached scorer, whether
+	// score ( a , b ) == score ( b , a ) and whether similarity_many scores
+	// a row of choices at once
+
+	template <typename CachedScorer>
+	struct _cdist_traits
+	{
+		typedef TokenizedString Tokenized;
+
+		static const bool tokenized = true;
+		static const bool symmetric = false;
+		static const bool batched   = false;
+		static const bool decoded   = false;
+	};
+
+	template <typename CharT>
+	struct _cdist_traits< BasicCachedRatio<CharT> > : _cdist_traits<void>
+	{
+		static const bool tokenized = false;
+		static const bool symmetric = true;
+		static const bool batched   = true;
+	};
+
+	template <typename CharT>
+	struct _cdist_traits< BasicCachedPartialRatio<CharT> > : _cdist_traits<void>
+	{
+		static const bool tokenized = false;
+	};
+
+	template <typename CharT>
+	struct _cdist_traits< BasicCachedTokenSortRatio<CharT> > : _cdist_traits<void>
+	{
+		static const bool symmetric = true;
+	};
+
+	template <typename CharT>
+	struct _cdist_traits< BasicCachedTokenSetRatio<CharT> > : _cdist_traits<void>
+	{
+		static const bool symmetric = true;
+	};
+
+	// the UTF-8 scorers tokenize the decoded choices
+	template <typename U32CachedScorer>
+	struct _cdist_traits< utf8::BasicCached<U32CachedScorer> > : _cdist_traits<U32CachedScorer>
+	{
+		typedef U32TokenizedString Tokenized;
+
+		static const bool tokenized = true;
+		static const bool batched   = false;
+		static const bool decoded   = true;
+	};
+
+	template <typename T>
+	inline T _cdist_value ( double score )
+	{
+		if constexpr ( std::is_integral<T>::value )
+			return (T) std::lround ( score );
+		else
+			return (T) score;
+	}
+
+	/* runs cells ( row , col_begin , col_end ) over tiles of the matrix on
+	*   pool. With symmetric only the cells on or above the diagonal are
+	*   visited. */
+	template <typename F>
+	void _cdist_tiles ( ThreadPool& pool , size_t rows , size_t cols , bool symmetric , F cells )
+	{
+		const size_t ROW_TILE = 16;
+		const size_t COL_TILE = 256;
+
+		size_t row_tiles = ( rows + ROW_TILE - 1 ) / ROW_TILE;
+		size_t col_tiles = ( cols + COL_TILE - 1 ) / COL_TILE;
+
+		pool.parallel_for ( row_tiles * col_tiles , [&] ( size_t tile , size_t )
+		{
+			size_t row_begin = ( tile / col_tiles ) * ROW_TILE;
+			size_t col_begin = ( tile % col_tiles ) * COL_TILE;
+			size_t row_end   = std::min ( rows , row_begin + ROW_TILE );
+			size_t col_end   = std::min ( cols , col_begin + COL_TILE );
+
+			if ( symmetric && col_end <= row_begin )
+				return;
+
+			for ( size_t row = row_begin; row < row_end; ++row )
+				cells ( row , symmetric ? std::max ( row , col_begin ) : col_begin , col_end );
+		});
+	}
+
+	//---------------------------------------------------------------------------
+
+	/* Scores every query against every choice. Scores below score_cutoff
+	*   are stored as 0; T = uint8_t stores rounded scores. Both sides are
+	*   preprocessed once: one cached scorer per query and, for token based
+	*   scorers, one TokenizedString per choice (decoded first for the
+	*   utf8:: scorers, which always tokenize). Passing the same vector as
+	*   queries and choices only scores the upper triangle for symmetric
+	*   scorers (ratio, token_sort_ratio, token_set_ratio) and mirrors it.
+	*/
+	template <typename T = float , typename CachedScorer = CachedRatio>
+	Matrix<T> cdist ( ThreadPool&                     pool    ,
+					  const std::vector<std::string>& queries , const std::vector<std::string>& choices ,
+					  Cached<CachedScorer>            = Cached<CachedScorer>() ,
+					  double                          score_cutoff = 0 )
+	{
+		typedef _cdist_traits<CachedScorer> traits;
+
+		Matrix<T> result ( queries.size() , choices.size() );
+
+		bool symmetric = traits::symmetric && &queries == &choices;
+
+		std::vector< std::optional<CachedScorer>                > cached   ( queries.size() );
+		std::vector< std::optional<typename traits::Tokenized> > prepared ( traits::tokenized ? choices.size() : 0 );
+
+		pool.parallel_for ( queries.size() , [&] ( size_t i , size_t )
+		{
+			cached[i].emplace ( queries[i] );
+		});
+
+		pool.parallel_for ( prepared.size() , [&] ( size_t i , size_t )
+		{
+			if constexpr ( traits::decoded )
+				prepared[i].emplace ( utf8_decode ( choices[i] ) );
+			else
+				prepared[i].emplace ( choices[i] );
+		});
+
+		_cdist_tiles ( pool , queries.size() , choices.size() , symmetric , [&] ( size_t row , size_t col_begin , size_t col_end )
+		{
+			double scores[256];  // COL_TILE of _cdist_tiles
+
+			// ratio scores a whole row of the tile at once
+			if constexpr ( traits::batched )
+				cached[row]->similarity_many ( &choices[col_begin] , col_end - col_begin , scores , score_cutoff );
+
+			for ( size_t col = col_begin; col < col_end; ++col )
+			{
+				double score;
+
+				if constexpr ( traits::batched )
+					score = scores[col - col_begin];
+				else if constexpr ( traits::tokenized )
+					score = cached[row]->similarity ( *prepared[col] , score_cutoff );
+				else
+					score = cached[row]->similarity ( choices[col] , score_cutoff );
+
+				result ( row , col ) = _cdist_value<T> ( score );
+
+				if ( symmetric )
+					result ( col , row ) = result ( row , col );
+			}
+		});
+
+		return result;
+	}
+
+	//---------------------------------------------------------------------------
+
+	/* Same as above on a pool of workers threads (0 uses one per hardware thread) */
+	template <typename T = float , typename CachedScorer = CachedRatio>
+	Matrix<T> cdist ( const std::vector<std::string>& queries , const std::vector<std::string>& choices ,
+					  Cached<CachedScorer>            scorer       = Cached<CachedScorer>() ,
+					  double                          score_cutoff = 0 ,
+					  size_t                          workers      = 1 )
+	{
+		ThreadPool pool ( workers );
+
+		return cdist<T> ( pool , queries , choices , scorer , score_cutoff );
+	}
+}
+}
+
+#endif
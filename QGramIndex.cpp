@@ -0,0 +1,371 @@
+#include "QGramIndex.h"
+#include <algorithm>
+#include <math.h>
+
+namespace FuzzyWuzzy
+{
+	//---------------------------------------------------------------------------
+
+	static inline size_t _varint_length ( uint64_t value )
+	{
+		size_t length = 1;
+
+		while ( value >= 0x80 )
+		{
+			value >>= 7;
+			length++;
+		}
+
+		return length;
+	}
+
+	static inline uint8_t* _varint_put ( uint8_t* dst , uint64_t value )
+	{
+		while ( value >= 0x80 )
+		{
+			*dst++ = (uint8_t) ( value | 0x80 );
+			value >>= 7;
+		}
+		*dst++ = (uint8_t) value;
+
+		return dst;
+	}
+
+	static inline const uint8_t* _varint_get ( const uint8_t* src , uint64_t& value )
+	{
+		unsigned shift = 0;
+
+		value = 0;
+		while ( *src & 0x80 )
+		{
+			value |= (uint64_t) ( *src++ & 0x7F ) << shift;
+			shift += 7;
+		}
+		value |= (uint64_t) *src++ << shift;
+
+		return src;
+	}
+
+	/* A posting is the id delta shifted left once, the low bit telling
+	*   whether a count follows. Single occurrences are the common case.
+	*/
+	static inline size_t _posting_length ( uint32_t delta , uint32_t count )
+	{
+		return _varint_length ( (uint64_t) delta << 1 ) + ( count > 1 ? _varint_length ( count ) : 0 );
+	}
+
+	static inline uint8_t* _posting_put ( uint8_t* dst , uint32_t delta , uint32_t count )
+	{
+		dst = _varint_put ( dst , ( (uint64_t) delta << 1 ) | ( count > 1 ) );
+		if ( count > 1 )
+			dst = _varint_put ( dst , count );
+
+		return dst;
+	}
+
+	//---------------------------------------------------------------------------
+
+	static inline size_t _gram_hash ( uint32_t key )
+	{
+		return (size_t) ( ( key * 0x9E3779B97F4A7C15ULL ) >> 32 );
+	}
+
+	size_t QGramIndex::_slot ( uint32_t key ) const
+	{
+		size_t mask = _slots.size() - 1;
+		size_t i    = _gram_hash ( key ) & mask;
+
+		while ( _slots[i] != 0 && _keys[_slots[i] - 1] != key )
+			i = ( i + 1 ) & mask;
+
+		return i;
+	}
+
+	size_t QGramIndex::_insert ( uint32_t key )
+	{
+		if ( 2 * ( _keys.size() + 1 ) > _slots.size() )
+		{
+			_slots.assign ( _slots.empty() ? 1024 : 2 * _slots.size() , 0 );
+
+			for ( size_t gram = 0 ; gram < _keys.size() ; gram++ )
+				_slots[_slot ( _keys[gram] )] = (uint32_t) ( gram + 1 );
+		}
+
+		size_t i = _slot ( key );
+
+		if ( _slots[i] == 0 )
+		{
+			_keys.push_back ( key );
+			_slots[i] = (uint32_t) _keys.size();
+		}
+
+		return _slots[i] - 1;
+	}
+
+	//---------------------------------------------------------------------------
+
+	/* The distinct q-grams of s with their number of occurrences */
+	void QGramIndex::_grams_of ( const std::string& s , std::vector<Gram>& grams ) const
+	{
+		grams.clear();
+		if ( s.length() < _q )
+			return;
+
+		const unsigned char* str = (const unsigned char*) s.data();
+		size_t               n   = s.length() - _q + 1;
+
+		grams.resize ( n );
+		for ( size_t i = 0 ; i < n ; i++ )
+		{
+			uint32_t key = 0;
+
+			for ( size_t j = 0 ; j < _q ; j++ )
+				key = ( key << 8 ) | str[i + j];
+
+			grams[i].key   = key;
+			grams[i].count = 1;
+		}
+
+		std::sort ( grams.begin() , grams.end() , [] ( const Gram& a , const Gram& b ) { return a.key < b.key; } );
+
+		size_t distinct = 0;
+
+		for ( size_t i = 0 ; i < n ; i++ )
+		{
+			if ( distinct > 0 && grams[distinct - 1].key == grams[i].key )
+				grams[distinct - 1].count++;
+			else
+				grams[distinct++] = grams[i];
+		}
+
+		grams.resize ( distinct );
+	}
+
+	//---------------------------------------------------------------------------
+
+	QGramIndex::QGramIndex ( const std::vector<std::string>& choices , size_t q )
+		: _choices ( &choices ) , _q ( std::min ( std::max ( q , (size_t) 1 ) , (size_t) 4 ) )
+	{
+		std::vector<Gram>     grams;
+		std::vector<uint32_t> last;      /* by gram, id of the last posting */
+		std::vector<uint64_t> lengths;   /* by gram, bytes of the posting list */
+		uint32_t              max_length = 0;
+
+		// first pass: directory and exact size of every posting list
+		_lengths.resize ( choices.size() );
+		for ( size_t id = 0 ; id < choices.size() ; id++ )
+		{
+			_lengths[id] = (uint32_t) choices[id].length();
+			max_length   = std::max ( max_length , _lengths[id] );
+
+			_grams_of ( choices[id] , grams );
+			for ( const Gram& g : grams )
+			{
+				size_t gram = _insert ( g.key );
+
+				if ( gram == last.size() )
+				{
+					last.push_back ( 0 );
+					lengths.push_back ( 0 );
+				}
+
+				lengths[gram] += _posting_length ( (uint32_t) id - last[gram] , g.count );
+				last[gram]     = (uint32_t) id;
+			}
+		}
+
+		_offsets.resize ( _keys.size() + 1 );
+		_offsets[0] = 0;
+		for ( size_t gram = 0 ; gram < _keys.size() ; gram++ )
+			_offsets[gram + 1] = _offsets[gram] + lengths[gram];
+
+		// second pass: the postings, written in place
+		std::vector<uint64_t> ends ( _offsets.begin() , _offsets.end() - 1 );
+
+		_postings.resize ( _offsets.back() );
+		std::fill ( last.begin() , last.end() , 0 );
+		for ( size_t id = 0 ; id < choices.size() ; id++ )
+		{
+			_grams_of ( choices[id] , grams );
+			for ( const Gram& g : grams )
+			{
+				size_t   gram = _slots[_slot ( g.key )] - 1;
+				uint8_t* dst  = &_postings[0] + ends[gram];
+
+				ends[gram] = _posting_put ( dst , (uint32_t) id - last[gram] , g.count ) - &_postings[0];
+				last[gram] = (uint32_t) id;
+			}
+		}
+
+		// ids grouped by length, for the lengths the filter cannot prune
+		_length_start.assign ( (size_t) max_length + 2 , 0 );
+		for ( size_t id = 0 ; id < choices.size() ; id++ )
+			_length_start[_lengths[id] + 1]++;
+		for ( size_t n = 1 ; n < _length_start.size() ; n++ )
+			_length_start[n] += _length_start[n - 1];
+
+		std::vector<uint32_t> fill ( _length_start.begin() , _length_start.end() - 1 );
+
+		_by_length.resize ( choices.size() );
+		for ( size_t id = 0 ; id < choices.size() ; id++ )
+			_by_length[fill[_lengths[id]]++] = (uint32_t) id;
+	}
+
+	//---------------------------------------------------------------------------
+
+	static const int64_t INFEASIBLE = INT64_MAX;
+
+	/* Lower bound on the q-grams that a query of length len1 shares with a
+	*   choice of length len2 whose ratio is at least r (0..1), INFEASIBLE when
+	*   the lengths alone rule it out. The Indel distance is at most k, spent
+	*   on dels deletions and ins insertions from the query to the choice: a
+	*   deletion destroys at most q q-grams of the query, an insertion at most
+	*   q - 1, and the other way round for the choice.
+	*/
+	static int64_t _ratio_need ( size_t len1 , size_t len2 , double r , size_t q )
+	{
+		int64_t lensum = (int64_t) ( len1 + len2 );
+		int64_t diff   = len1 > len2 ? (int64_t) ( len1 - len2 ) : (int64_t) ( len2 - len1 );
+		int64_t k      = (int64_t) floor ( ( 1.0 - r ) * (double) lensum + 1e-7 );
+
+		if ( diff > k )
+			return INFEASIBLE;
+
+		// the distance has the parity of the length difference
+		int64_t d    = k - ( ( k - diff ) & 1 );
+		int64_t dels = ( d + (int64_t) len1 - (int64_t) len2 ) / 2;
+		int64_t ins  = d - dels;
+		int64_t Q    = (int64_t) q;
+
+		int64_t need1 = (int64_t) len1 - Q + 1 - Q * dels - ( Q - 1 ) * ins;
+		int64_t need2 = (int64_t) len2 - Q + 1 - Q * ins  - ( Q - 1 ) * dels;
+
+		return std::max ( need1 , need2 );
+	}
+
+	/* Same for partial_ratio: the best window of the longer string is at most
+	*   as long as the shorter one and within Indel distance 2 * m * (1 - r)
+	*   of it, and its q-grams are q-grams of the longer string
+	*/
+	static int64_t _partial_need ( size_t len1 , size_t len2 , double r , size_t q )
+	{
+		int64_t m = (int64_t) std::min ( len1 , len2 );
+		int64_t k = (int64_t) floor ( ( 1.0 - r ) * (double) ( 2 * m ) + 1e-7 );
+		int64_t Q = (int64_t) q;
+
+		return m - Q + 1 - Q * k;
+	}
+
+	//---------------------------------------------------------------------------
+
+	void QGramIndex::candidates ( const std::string& query , double score_cutoff , bool partial ,
+								  std::vector<uint32_t>& ids ) const
+	{
+		static thread_local std::vector<Gram>     grams;
+		static thread_local std::vector<int64_t>  need;      /* by choice length */
+		static thread_local std::vector<uint32_t> counts;    /* by id, shared q-grams */
+		static thread_local std::vector<uint32_t> touched;
+
+		ids.clear();
+		if ( score_cutoff > 100 || _choices->empty() )
+			return;
+
+		// partial_ratio rounds windows above 0.995 up to 100
+		double r = ( partial ? std::min ( score_cutoff , 99.5 ) : score_cutoff ) / 100.0;
+
+		bool filtered = false;
+
+		need.resize ( _length_start.size() - 1 );
+		for ( size_t len = 0 ; len < need.size() ; len++ )
+		{
+			if ( _length_start[len + 1] == _length_start[len] )
+				need[len] = INFEASIBLE;
+			else if ( partial )
+				need[len] = _partial_need ( query.length() , len , r , _q );
+			else
+				need[len] = _ratio_need ( query.length() , len , r , _q );
+
+			filtered |= need[len] > 0 && need[len] != INFEASIBLE;
+		}
+
+		// ScanCount over the posting lists of the query's q-grams, unless no
+		// length needs any
+		_grams_of ( query , grams );
+		counts.resize ( size() , 0 );
+		touched.clear();
+
+		if ( filtered && !_slots.empty() )
+		{
+			for ( const Gram& g : grams )
+			{
+				uint32_t gram = _slots[_slot ( g.key )];
+
+				if ( gram == 0 )
+					continue;
+
+				const uint8_t* src = &_postings[0] + _offsets[gram - 1];
+				const uint8_t* end = &_postings[0] + _offsets[gram];
+				uint32_t       id  = 0;
+
+				while ( src < end )
+				{
+					uint64_t value;
+					uint64_t count = 1;
+
+					src = _varint_get ( src , value );
+					if ( value & 1 )
+						src = _varint_get ( src , count );
+					id += (uint32_t) ( value >> 1 );
+
+					if ( counts[id] == 0 )
+						touched.push_back ( id );
+
+					counts[id] += (uint32_t) std::min<uint64_t> ( count , g.count );
+				}
+			}
+		}
+
+		// lengths at which a choice may reach the cutoff sharing no q-gram
+		size_t unfiltered = 0;
+
+		for ( size_t len = 0 ; len < need.size() ; len++ )
+		{
+			if ( need[len] <= 0 )
+				unfiltered += _length_start[len + 1] - _length_start[len];
+		}
+
+		// many of those: one pass in id order instead of sorting them
+		if ( unfiltered * 8 >= size() )
+		{
+			for ( size_t id = 0 ; id < size() ; id++ )
+			{
+				int64_t n = need[_lengths[id]];
+
+				if ( n <= 0 || ( n != INFEASIBLE && counts[id] >= n ) )
+					ids.push_back ( (uint32_t) id );
+			}
+
+			for ( uint32_t id : touched )
+				counts[id] = 0;
+
+			return;
+		}
+
+		for ( uint32_t id : touched )
+		{
+			int64_t n = need[_lengths[id]];
+
+			if ( n > 0 && n != INFEASIBLE && counts[id] >= n )
+				ids.push_back ( id );
+			counts[id] = 0;
+		}
+
+		for ( size_t len = 0 ; len < need.size() ; len++ )
+		{
+			if ( need[len] <= 0 )
+				ids.insert ( ids.end() , _by_length.begin() + _length_start[len] , _by_length.begin() + _length_start[len + 1] );
+		}
+
+		std::sort ( ids.begin() , ids.end() );
+	}
+}
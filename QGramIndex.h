@@ -0,0 +1,79 @@
+#ifndef QGramIndexH
+#define QGramIndexH
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace FuzzyWuzzy
+{
+	/* Inverted index of the q-grams (runs of q bytes, q <= 4) of a list of
+	*   choices, to find the choices that can reach a ratio or partial_ratio
+	*   cutoff without scoring all of them. The posting list of a q-gram holds
+	*   the ids of the choices containing it, delta and varint coded, each
+	*   followed by the number of occurrences when there are several.
+	*
+	*   Candidates come from the count filter: every Indel edit destroys at
+	*   most q of the q-grams of a string, so a choice within the distance the
+	*   cutoff allows shares at least a known number of q-grams with the query.
+	*   The filter never drops a choice that reaches the cutoff. Choices of a
+	*   length at which that number is not positive are all candidates, which
+	*   is why short strings and low cutoffs call for a smaller q.
+	*
+	*   The q-grams and lengths are those of bytes, so the bounds hold for
+	*   the byte scorers only: a character above ASCII is several bytes in
+	*   UTF-8 and one edit for the utf8:: scorers. Code point terms within a
+	*   few edits are found by U32BKTree or U32SymSpellIndex.
+	*
+	*   The choices are not copied: they must outlive the index. Queries do not
+	*   change the index and may run on several threads at once.
+	*/
+	class QGramIndex
+	{
+	private :
+
+		struct Gram
+		{
+			uint32_t key;
+			uint32_t count;
+		};
+
+		const std::vector<std::string>* _choices;
+		size_t                          _q;
+
+		std::vector<uint32_t>           _lengths;        /* by id */
+		std::vector<uint32_t>           _length_start;   /* ids of length n are _by_length[_length_start[n] ..) */
+		std::vector<uint32_t>           _by_length;
+
+		std::vector<uint32_t>           _slots;          /* gram + 1, 0 marks a free slot */
+		std::vector<uint32_t>           _keys;           /* by gram */
+		std::vector<uint64_t>           _offsets;        /* by gram, into _postings */
+		std::vector<uint8_t>            _postings;
+
+		void   _grams_of ( const std::string& s , std::vector<Gram>& grams ) const;
+		size_t _slot     ( uint32_t key ) const;
+		size_t _insert   ( uint32_t key );
+
+	public:
+
+		QGramIndex ( const std::vector<std::string>& choices , size_t q = 3 );
+
+		size_t                          size    ( void )      const { return _choices->size(); }
+		const std::string&              choice  ( size_t id ) const { return (*_choices)[id]; }
+		const std::vector<std::string>& choices ( void )      const { return *_choices; }
+		size_t                          q       ( void )      const { return _q; }
+
+		// size of the compressed posting lists in bytes
+		size_t                          posting_bytes ( void ) const { return _postings.size(); }
+
+		/* The ids of the choices whose ratio with query may reach score_cutoff,
+		*   in increasing order, or those whose partial_ratio may when partial
+		*   is set. The candidates still have to be scored.
+		*/
+		void candidates ( const std::string& query , double score_cutoff , bool partial ,
+						  std::vector<uint32_t>& ids ) const;
+	};
+}
+
+#endif
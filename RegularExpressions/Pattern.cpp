@@ -37,12 +37,19 @@
 #include <cstring>
 #include <typeinfo>
 #include <algorithm>
+#include <mutex>
+#include <shared_mutex>
 #include <ctype.h>
 #include <stdio.h>
 
 std::map<std::string, Pattern *> Pattern::compiledPatterns;
 std::map<std::string, std::pair<std::string, unsigned long> > Pattern::registeredPatterns;
 
+// Both tables are read far more often than written: lookups take a shared
+// lock, registration and cache updates an exclusive one.
+static std::shared_mutex compiledPatternsLock;
+static std::shared_mutex registeredPatternsLock;
+
 const int Pattern::MIN_QMATCH = 0x00000000;
 const int Pattern::MAX_QMATCH = 0x7FFFFFFF;
 
@@ -54,7 +61,6 @@ const unsigned long Pattern::UNIX_LINE_MODE         = 0x10;
 
 Pattern::Pattern(const std::string & rhs)
 {
-  matcher = NULL;
   pattern = rhs;
   curInd = 0;
   groupCount = 0;
@@ -615,16 +621,27 @@ NFANode * Pattern::parseRegisteredPattern(NFANode ** end)
     }
   }
   s = pattern.substr(curInd, i - curInd);
-  if (registeredPatterns.find(s) == registeredPatterns.end()) raiseError();
+  std::pair<std::string, unsigned long> registered;
+  bool found = false;
+  {
+    std::shared_lock<std::shared_mutex> lock(registeredPatternsLock);
+    std::map<std::string, std::pair<std::string, unsigned long> >::const_iterator it = registeredPatterns.find(s);
+    if (it != registeredPatterns.end())
+    {
+      registered = it->second;
+      found = true;
+    }
+  }
+  if (!found) raiseError();
   else
   {
     unsigned long oflags = flags;
     std::string op = pattern;
     int ci = i + 1;
 
-    pattern = registeredPatterns[s].first;
+    pattern = registered.first;
     curInd = 0;
-    flags = registeredPatterns[s].second;
+    flags = registered.second;
 
     --groupCount;
     ret = parse(0, 0, end);
@@ -995,27 +1012,25 @@ Pattern * Pattern::compile(const std::string & pattern, const unsigned long mode
       end->next = p->registerNode(new NFAEndNode);
     }
   }
-  if (p != NULL)
-  {
-    p->matcher = new Matcher(p, "");
-  }
-
   return p;
 }
 
 Pattern * Pattern::compileAndKeep(const std::string & pattern, const unsigned long mode)
 {
-  Pattern * ret = NULL;
-  std::map<std::string, Pattern*>::iterator it = compiledPatterns.find(pattern);
-
-  if (it != compiledPatterns.end())
   {
-    ret = it->second;
+    std::shared_lock<std::shared_mutex> lock(compiledPatternsLock);
+    std::map<std::string, Pattern*>::iterator it = compiledPatterns.find(pattern);
+    if (it != compiledPatterns.end()) return it->second;
   }
-  else
+
+  // compile outside of the lock; if another thread won the race keep its copy
+  Pattern * ret = compile(pattern, mode);
+  std::unique_lock<std::shared_mutex> lock(compiledPatternsLock);
+  std::pair<std::map<std::string, Pattern*>::iterator, bool> ins = compiledPatterns.insert(std::make_pair(pattern, ret));
+  if (!ins.second)
   {
-    ret = compile(pattern, mode);
-    compiledPatterns[pattern] = ret;
+    delete ret;
+    ret = ins.first->second;
   }
 
   return ret;
@@ -1076,6 +1091,7 @@ bool Pattern::registerPattern(const std::string & name, const std::string & patt
 {
   Pattern * p = Pattern::compile(pattern, mode);
   if (!p) return 0;
+  std::unique_lock<std::shared_mutex> lock(registeredPatternsLock);
   Pattern::registeredPatterns[name] = std::make_pair(pattern, mode);
   delete p;
   return 1;
@@ -1083,10 +1099,12 @@ bool Pattern::registerPattern(const std::string & name, const std::string & patt
 
 void Pattern::unregisterPatterns()
 {
+  std::unique_lock<std::shared_mutex> lock(registeredPatternsLock);
   registeredPatterns.clear();
 }
 void Pattern::clearPatternCache()
 {
+  std::unique_lock<std::shared_mutex> lock(compiledPatternsLock);
   std::map<std::string, Pattern*>::iterator it;
   for (it = compiledPatterns.begin(); it != compiledPatterns.end(); ++it)
   {
@@ -1105,12 +1123,13 @@ std::pair<std::string, int>  Pattern::findNthMatch(const std::string & pattern,
   if (p)
   {
     int i = -1;
-    p->matcher->setString(str);
-    while (i < matchNum && p->matcher->findNextMatch()) { ++i; }
-    if (i == matchNum && p->matcher->getStartingIndex() >= 0)
+    Matcher matcher(p, str);
+    matcher.reset();
+    while (i < matchNum && matcher.findNextMatch()) { ++i; }
+    if (i == matchNum && matcher.getStartingIndex() >= 0)
     {
-      ret.first = p->matcher->getGroup(0);
-      ret.second = p->matcher->getStartingIndex();
+      ret.first = matcher.getGroup(0);
+      ret.second = matcher.getStartingIndex();
     }
     delete p;
   }
@@ -1120,7 +1139,6 @@ std::pair<std::string, int>  Pattern::findNthMatch(const std::string & pattern,
 
 Pattern::~Pattern()
 {
-  if (matcher) delete matcher;
   for (std::map<NFANode*, bool>::iterator it = nodes.begin(); it != nodes.end(); ++it)
   {
     delete it->first;
@@ -1131,12 +1149,13 @@ std::string Pattern::replace(const std::string & str, const std::string & replac
   int li = 0;
   std::string ret = "";
 
-  matcher->setString(str);
-  while (matcher->findNextMatch())
+  Matcher matcher(this, str);
+  matcher.reset();
+  while (matcher.findNextMatch())
   {
-    ret += str.substr(li, matcher->getStartingIndex() - li);
-    ret += matcher->replaceWithGroups(replacementText);
-    li = matcher->getEndingIndex();
+    ret += str.substr(li, matcher.getStartingIndex() - li);
+    ret += matcher.replaceWithGroups(replacementText);
+    li = matcher.getEndingIndex();
   }
   ret += str.substr(li);
 
@@ -1148,18 +1167,19 @@ std::vector<std::string> Pattern::split(const std::string & str, const bool keep
   int li = 0;
   std::vector<std::string> ret;
 
-  matcher->setString(str);
+  Matcher matcher(this, str);
+  matcher.reset();
 
-  while (matcher->findNextMatch() && ret.size() < lim)
+  while (matcher.findNextMatch() && ret.size() < lim)
   {
-    if (matcher->getStartingIndex() == 0 && keepEmptys) ret.push_back("");
-    if ((matcher->getStartingIndex() != matcher->getEndingIndex()) || keepEmptys)
+    if (matcher.getStartingIndex() == 0 && keepEmptys) ret.push_back("");
+    if ((matcher.getStartingIndex() != matcher.getEndingIndex()) || keepEmptys)
     {
-      if (li != matcher->getStartingIndex() || keepEmptys)
+      if (li != matcher.getStartingIndex() || keepEmptys)
       {
-        ret.push_back(str.substr(li, matcher->getStartingIndex() - li));
+        ret.push_back(str.substr(li, matcher.getStartingIndex() - li));
       }
-      li = matcher->getEndingIndex();
+      li = matcher.getEndingIndex();
     }
   }
   if (li < (int)str.size()) ret.push_back(str.substr(li));
@@ -1168,13 +1188,15 @@ std::vector<std::string> Pattern::split(const std::string & str, const bool keep
 }
 std::vector<std::string> Pattern::findAll(const std::string & str)
 {
-  matcher->setString(str);
-  return matcher->findAll();
+  Matcher matcher(this, str);
+  matcher.reset();
+  return matcher.findAll();
 }
 bool Pattern::matches(const std::string & str)
 {
-  matcher->setString(str);
-  return matcher->matches();
+  Matcher matcher(this, str);
+  matcher.reset();
+  return matcher.matches();
 }
 unsigned long Pattern::getFlags() const
 {
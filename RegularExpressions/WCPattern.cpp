@@ -33,6 +33,8 @@
 #include <cstring>
 #include <wchar.h>
 #include <algorithm>
+#include <mutex>
+#include <shared_mutex>
 #ifndef _WIN32
   #include <wctype.h>
 
@@ -44,6 +46,11 @@
 std::map<std::wstring, WCPattern *> WCPattern::compiledWCPatterns;
 std::map<std::wstring, std::pair<std::wstring, unsigned long> > WCPattern::registeredWCPatterns;
 
+// Both tables are read far more often than written: lookups take a shared
+// lock, registration and cache updates an exclusive one.
+static std::shared_mutex compiledWCPatternsLock;
+static std::shared_mutex registeredWCPatternsLock;
+
 const int WCPattern::MIN_QMATCH = 0x00000000;
 const int WCPattern::MAX_QMATCH = 0x7FFFFFFF;
 
@@ -79,7 +86,6 @@ const unsigned long WCPattern::UNIX_LINE_MODE         = 0x10;
 
 WCPattern::WCPattern(const std::wstring & rhs)
 {
-  matcher = NULL;
   pattern = rhs;
   curInd = 0;
   groupCount = 0;
@@ -654,16 +660,27 @@ NFAUNode * WCPattern::parseRegisteredWCPattern(NFAUNode ** end)
     }
   }
   s = pattern.substr(curInd, i - curInd);
-  if (registeredWCPatterns.find(s) == registeredWCPatterns.end()) raiseError();
+  std::pair<std::wstring, unsigned long> registered;
+  bool found = false;
+  {
+    std::shared_lock<std::shared_mutex> lock(registeredWCPatternsLock);
+    std::map<std::wstring, std::pair<std::wstring, unsigned long> >::const_iterator it = registeredWCPatterns.find(s);
+    if (it != registeredWCPatterns.end())
+    {
+      registered = it->second;
+      found = true;
+    }
+  }
+  if (!found) raiseError();
   else
   {
     unsigned long oflags = flags;
     std::wstring op = pattern;
     int ci = i + 1;
 
-    pattern = registeredWCPatterns[s].first;
+    pattern = registered.first;
     curInd = 0;
-    flags = registeredWCPatterns[s].second;
+    flags = registered.second;
 
     --groupCount;
     ret = parse(0, 0, end);
@@ -1026,27 +1043,25 @@ WCPattern * WCPattern::compile(const std::wstring & pattern, const unsigned long
       end->next = p->registerNode(new NFAEndUNode);
     }
   }
-  if (p != NULL)
-  {
-    p->matcher = new WCMatcher(p, L"");
-  }
-
   return p;
 }
 
 WCPattern * WCPattern::compileAndKeep(const std::wstring & pattern, const unsigned long mode)
 {
-  WCPattern * ret = NULL;
-  std::map<std::wstring, WCPattern*>::iterator it = compiledWCPatterns.find(pattern);
-
-  if (it != compiledWCPatterns.end())
   {
-    ret = it->second;
+    std::shared_lock<std::shared_mutex> lock(compiledWCPatternsLock);
+    std::map<std::wstring, WCPattern*>::iterator it = compiledWCPatterns.find(pattern);
+    if (it != compiledWCPatterns.end()) return it->second;
   }
-  else
+
+  // compile outside of the lock; if another thread won the race keep its copy
+  WCPattern * ret = compile(pattern, mode);
+  std::unique_lock<std::shared_mutex> lock(compiledWCPatternsLock);
+  std::pair<std::map<std::wstring, WCPattern*>::iterator, bool> ins = compiledWCPatterns.insert(std::make_pair(pattern, ret));
+  if (!ins.second)
   {
-    ret = compile(pattern, mode);
-    compiledWCPatterns[pattern] = ret;
+    delete ret;
+    ret = ins.first->second;
   }
 
   return ret;
@@ -1107,6 +1122,7 @@ bool WCPattern::registerWCPattern(const std::wstring & name, const std::wstring
 {
   WCPattern * p = WCPattern::compile(pattern, mode);
   if (!p) return 0;
+  std::unique_lock<std::shared_mutex> lock(registeredWCPatternsLock);
   WCPattern::registeredWCPatterns[name] = std::make_pair(pattern, mode);
   delete p;
   return 1;
@@ -1114,10 +1130,12 @@ bool WCPattern::registerWCPattern(const std::wstring & name, const std::wstring
 
 void WCPattern::unregisterWCPatterns()
 {
+  std::unique_lock<std::shared_mutex> lock(registeredWCPatternsLock);
   registeredWCPatterns.clear();
 }
 void WCPattern::clearWCPatternCache()
 {
+  std::unique_lock<std::shared_mutex> lock(compiledWCPatternsLock);
   std::map<std::wstring, WCPattern*>::iterator it;
   for (it = compiledWCPatterns.begin(); it != compiledWCPatterns.end(); ++it)
   {
@@ -1136,12 +1154,13 @@ std::pair<std::wstring, int>  WCPattern::findNthMatch(const std::wstring & patte
   if (p)
   {
     int i = -1;
-    p->matcher->setString(str);
-    while (i < matchNum && p->matcher->findNextMatch()) { ++i; }
-    if (i == matchNum && p->matcher->getStartingIndex() >= 0)
+    WCMatcher matcher(p, str);
+    matcher.reset();
+    while (i < matchNum && matcher.findNextMatch()) { ++i; }
+    if (i == matchNum && matcher.getStartingIndex() >= 0)
     {
-      ret.first = p->matcher->getGroup(0);
-      ret.second = p->matcher->getStartingIndex();
+      ret.first = matcher.getGroup(0);
+      ret.second = matcher.getStartingIndex();
     }
     delete p;
   }
@@ -1155,7 +1174,6 @@ WCPattern::~WCPattern()
   nodes.clear();
   if (head) head->findAllNodes(nodes);
   */
-  if (matcher) delete matcher;
   for (std::map<NFAUNode*, bool>::iterator it = nodes.begin(); it != nodes.end(); ++it) delete it->first;
 }
 std::wstring WCPattern::replace(const std::wstring & str, const std::wstring & replacementText)
@@ -1163,12 +1181,13 @@ std::wstring WCPattern::replace(const std::wstring & str, const std::wstring & r
   int li = 0;
   std::wstring ret = L"";
 
-  matcher->setString(str);
-  while (matcher->findNextMatch())
+  WCMatcher matcher(this, str);
+  matcher.reset();
+  while (matcher.findNextMatch())
   {
-    ret += str.substr(li, matcher->getStartingIndex() - li);
-    ret += matcher->replaceWithGroups(replacementText);
-    li = matcher->getEndingIndex();
+    ret += str.substr(li, matcher.getStartingIndex() - li);
+    ret += matcher.replaceWithGroups(replacementText);
+    li = matcher.getEndingIndex();
   }
   ret += str.substr(li);
 
@@ -1180,18 +1199,19 @@ std::vector<std::wstring> WCPattern::split(const std::wstring & str, const bool
   int li = 0;
   std::vector<std::wstring> ret;
 
-  matcher->setString(str);
+  WCMatcher matcher(this, str);
+  matcher.reset();
 
-  while (matcher->findNextMatch() && ret.size() < lim)
+  while (matcher.findNextMatch() && ret.size() < lim)
   {
-    if (matcher->getStartingIndex() == 0 && keepEmptys) ret.push_back(L"");
-    if ((matcher->getStartingIndex() != matcher->getEndingIndex()) || keepEmptys)
+    if (matcher.getStartingIndex() == 0 && keepEmptys) ret.push_back(L"");
+    if ((matcher.getStartingIndex() != matcher.getEndingIndex()) || keepEmptys)
     {
-      if (li != matcher->getStartingIndex() || keepEmptys)
+      if (li != matcher.getStartingIndex() || keepEmptys)
       {
-        ret.push_back(str.substr(li, matcher->getStartingIndex() - li));
+        ret.push_back(str.substr(li, matcher.getStartingIndex() - li));
       }
-      li = matcher->getEndingIndex();
+      li = matcher.getEndingIndex();
     }
   }
   if (li < (int)str.size()) ret.push_back(str.substr(li));
@@ -1200,13 +1220,15 @@ std::vector<std::wstring> WCPattern::split(const std::wstring & str, const bool
 }
 std::vector<std::wstring> WCPattern::findAll(const std::wstring & str)
 {
-  matcher->setString(str);
-  return matcher->findAll();
+  WCMatcher matcher(this, str);
+  matcher.reset();
+  return matcher.findAll();
 }
 bool WCPattern::matches(const std::wstring & str)
 {
-  matcher->setString(str);
-  return matcher->matches();
+  WCMatcher matcher(this, str);
+  matcher.reset();
+  return matcher.matches();
 }
 unsigned long WCPattern::getFlags() const
 {
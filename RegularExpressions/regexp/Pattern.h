@@ -40,9 +40,10 @@ class NFAQuantifierNode;
   This class does not currently support unicode. The unicode update for this
   class is coming soon.
 
-  This class is partially immutable. It is completely safe to call createMatcher
-  concurrently in different threads, but the other functions (e.g. split) should
-  not be called concurrently on the same <code>Pattern</code>.
+  This class is immutable once compiled. Functions such as split, findAll and
+  matches build their own matcher for every call, so they and createMatcher may
+  be called concurrently on the same <code>Pattern</code>. The compiled and
+  registered pattern tables are guarded by reader/writer locks.
 
   <table border="0" cellpadding="1" cellspacing="0">
     <tr align="left" bgcolor="#CCCCFF">
@@ -1001,12 +1002,6 @@ class Pattern
       clean-up from an unsuccessful compile much easier and faster.
      */
     std::map<NFANode*, bool> nodes;
-    /**
-      Used when methods like split are called. The matcher class uses a lot of
-      dynamic memeory, so having an instance increases speedup of certain
-      operations.
-     */
-    Matcher * matcher;
     /**
       The front node of the NFA.
      */
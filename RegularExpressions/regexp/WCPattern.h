@@ -45,9 +45,10 @@ namespace std
   This class does not currently support unicode. The unicode update for this
   class is coming soon.
 
-  This class is partially immutable. It is completely safe to call createWCMatcher
-  concurrently in different threads, but the other functions (e.g. split) should
-  not be called concurrently on the same <code>WCPattern</code>.
+  This class is immutable once compiled. Functions such as split, findAll and
+  matches build their own matcher for every call, so they and createWCMatcher
+  may be called concurrently on the same <code>WCPattern</code>. The compiled
+  and registered pattern tables are guarded by reader/writer locks.
 
   <table border="0" cellpadding="1" cellspacing="0">
     <tr align="left" bgcolor="#CCCCFF">
@@ -1006,12 +1007,6 @@ class WCPattern
       clean-up from an unsuccessful compile much easier and faster.
      */
     std::map<NFAUNode*, bool> nodes;
-    /**
-      Used when methods like split are called. The matcher class uses a lot of
-      dynamic memeory, so having an instance increases speedup of certain
-      operations.
-     */
-    WCMatcher * matcher;
     /**
       The front node of the NFA.
      */
@@ -1,5 +1,8 @@
 #include "StringMatcher.h"
 #include "Levenshtein.h"
+#include <algorithm>
+#include <cmath>
+#include <stdint.h>
 #include <vector>
 #include <iostream>
 
@@ -28,115 +31,87 @@ namespace FuzzyWuzzy
 	//---------------------------------------------------------------------------
 	//---------------------------------------------------------------------------
 	
-	int SequenceMatcher::Levenshtein ( const std::string& left , const std::string& right , int cost )
+	template <typename CharT , typename String>
+	int BasicSequenceMatcher<CharT,String>::Levenshtein ( View left , View right , int cost )
 	{
-		return lev_edit_distance ( left.length()   , left.c_str() ,
-								   right.length()  , right.c_str() ,
+		return lev_edit_distance ( left.length()   , left.data() ,
+								   right.length()  , right.data() ,
 						           cost );
 	}
 
 	//---------------------------------------------------------------------------
 
-	SequenceMatcher::SequenceMatcher ( const std::string& str1 , const std::string& str2 )
+	template <typename CharT , typename String>
+	int BasicSequenceMatcher<CharT,String>::Levenshtein ( View left , View right , int cost , size_t max )
 	{
-		_str1            = str1;
-		_str2            = str2;
-		_matching_blocks = NULL;
+		return lev_edit_distance ( left.length()   , left.data() ,
+								   right.length()  , right.data() ,
+						           cost , max );
+	}
+
+	//---------------------------------------------------------------------------
 
+	template <typename CharT , typename String>
+	BasicSequenceMatcher<CharT,String>::BasicSequenceMatcher ( const String& str1 , const String& str2 ) :
+		_str1 ( str1 ) ,
+		_str2 ( str2 )
+	{
 		_reset_cache();  
 	};
 
 	//---------------------------------------------------------------------------
 
-	SequenceMatcher::~SequenceMatcher ( void )
+	template <typename CharT , typename String>
+	BasicSequenceMatcher<CharT,String>::~BasicSequenceMatcher ( void )
 	{
-		if ( _matching_blocks != NULL )
-		{
-			delete _matching_blocks;
-			_matching_blocks = NULL;
-		}
 	}
 
 	//---------------------------------------------------------------------------
 
-	void SequenceMatcher::_reset_cache ( void )
+	template <typename CharT , typename String>
+	void BasicSequenceMatcher<CharT,String>::_reset_cache ( void )
 	{
 		_ratio = _distance = -1;
 
-		if ( _matching_blocks != NULL )
-			delete _matching_blocks;
-
-		_matching_blocks = NULL;
+		_matching_blocks.clear();
+		_has_matching_blocks = false;
 	};
 
 	//---------------------------------------------------------------------------
 
-	std::vector<Triple>* SequenceMatcher::get_matching_blocks ( void )
+	/* Matching blocks of python-Levenshtein's StringMatcher, computed from the
+	*   Levenshtein edit operations, so the last block is (len1, len2, 0).
+	*/
+	template <typename CharT , typename String>
+	std::vector<Triple>* BasicSequenceMatcher<CharT,String>::get_matching_blocks ( void )
 	{
-		if ( _matching_blocks != NULL )
-			return _matching_blocks;
-
-		_matching_blocks = new std::vector<Triple>();
-
-		int str1_length = _str1.length();
-		int str2_length = _str2.length();
-		int str1_idx    = 0;
-
-		bool mustSave = false;
+		if ( _has_matching_blocks )
+			return &_matching_blocks;
 
-		int str2_idx    = -1;
+		_has_matching_blocks = true;
 
-		int buffer_length = 1;
+		LevScratch&                    scratch = lev_thread_scratch();
+		std::vector<LevMatchingBlock>& blocks  = scratch.blocks;
 
-		while ( str1_idx + buffer_length - 1 < str1_length )
-		{
-			std::string buffer_1 = _str1.substr ( str1_idx , buffer_length );
-
-			size_t pos = _str2.find ( buffer_1 , str2_idx < 0 ? 0 : str2_idx );
-
-			if ( pos == std::string::npos )
-			{
-				// Check&save last ocurrence
-				if ( str2_idx >= 0 && mustSave )
-				{
-					Triple ocurrence ( str1_idx , str2_idx , buffer_length - 1 );
-					_matching_blocks->push_back ( ocurrence );
-
-					str1_idx += buffer_length - 1;
-					str2_idx += buffer_length - 1;
-
-					mustSave = false;
-				}
-				else
-				{
-					str1_idx++;
-				}
+		lev_matching_blocks ( _str1.length() , _str1.data() ,
+							  _str2.length() , _str2.data() ,
+							  blocks , scratch );
 
-				buffer_length = 1;
-			}
-			else
-			{
-				str2_idx = pos;
-				buffer_length++;
-				mustSave = true;
-			}
-		}
+		_matching_blocks.reserve ( blocks.size() );
 
-		if ( str2_idx >= 0 && mustSave )
+		for ( size_t i = 0 ; i < blocks.size() ; i++ )
 		{
-			Triple ocurrence ( str1_idx , str2_idx , buffer_length - 1 );
-			_matching_blocks->push_back ( ocurrence );
+			Triple block ( blocks[i].spos , blocks[i].dpos , blocks[i].len );
+			_matching_blocks.push_back ( block );
 		}
 
-		Triple dummy ( str1_length , str2_length , 0 );
-		_matching_blocks->push_back ( dummy );
-
-		return _matching_blocks;
+		return &_matching_blocks;
 	}
 
 	//---------------------------------------------------------------------------
 
-	double SequenceMatcher::ratio ( void )
+	template <typename CharT , typename String>
+	double BasicSequenceMatcher<CharT,String>::ratio ( void )
 	{
 		if ( _ratio == -1 )
 		{
@@ -159,7 +134,122 @@ namespace FuzzyWuzzy
 
 	//---------------------------------------------------------------------------
 
-	int SequenceMatcher::distance ( void )
+	/* Same as ratio(), but returns 0 when the ratio is below score_cutoff (0..1).
+	*   Pairs whose real_quick_ratio() or quick_ratio() is below the cutoff are
+	*   rejected right away. Otherwise the cutoff is turned into the largest Indel
+	*   distance that can still reach it, so hopeless pairs leave the distance
+	*   computation early.
+	*/
+	template <typename CharT , typename String>
+	double BasicSequenceMatcher<CharT,String>::ratio ( double score_cutoff )
+	{
+		if ( _ratio == -1 && score_cutoff > 0 )
+		{
+			int lensum = _str1.length() + _str2.length();
+
+			if ( lensum == 0 )
+				return ratio();
+
+			if ( score_cutoff > 1.0 )
+				return 0;
+
+			if ( real_quick_ratio() < score_cutoff )
+				return 0;
+
+			// below one machine word the bit-parallel distance costs about as
+			// much as the histogram, beyond it a fraction
+			if ( _str1.length() > 64 && _str2.length() > 64 && quick_ratio() < score_cutoff )
+				return 0;
+
+			size_t max   = (size_t) std::floor ( ( 1.0 - score_cutoff ) * lensum + 1e-7 );
+			int    ldist = Levenshtein ( _str1 , _str2 , 1 , max );
+
+			if ( (size_t) ldist > max )
+				return 0;
+
+			_ratio = (double)(lensum - ldist)/(double)lensum;
+		}
+
+		return ratio() >= score_cutoff ? ratio() : 0;
+	}
+
+	//---------------------------------------------------------------------------
+
+	/* Upper bound of ratio() from the characters both strings have in common,
+	*   whatever their order (difflib's quick_ratio)
+	*/
+	template <typename CharT , typename String>
+	double BasicSequenceMatcher<CharT,String>::quick_ratio ( void )
+	{
+		size_t lensum = _str1.length() + _str2.length();
+
+		if ( lensum == 0 )
+			return 1.0;
+
+		size_t matches = 0;
+
+		if constexpr ( sizeof ( CharT ) == 1 )
+		{
+			// characters of str1 not used up yet, str2 takes them one by one
+			int32_t available[256] = { 0 };
+
+			for ( size_t i = 0 ; i < _str1.length() ; i++ )
+				available[ (unsigned char) _str1[i] ]++;
+			for ( size_t i = 0 ; i < _str2.length() ; i++ )
+				matches += available[ (unsigned char) _str2[i] ]-- > 0;
+		}
+		else
+		{
+			// too many characters for a table: merge the sorted strings, in
+			// buffers each thread keeps so that a call does not allocate
+			static thread_local std::basic_string<CharT> sorted1 , sorted2;
+
+			sorted1.assign ( _str1.data() , _str1.length() );
+			sorted2.assign ( _str2.data() , _str2.length() );
+
+			std::sort ( sorted1.begin() , sorted1.end() );
+			std::sort ( sorted2.begin() , sorted2.end() );
+
+			for ( size_t i = 0 , j = 0 ; i < sorted1.length() && j < sorted2.length() ; )
+			{
+				if ( sorted1[i] < sorted2[j] )
+					i++;
+				else if ( sorted2[j] < sorted1[i] )
+					j++;
+				else
+				{
+					matches++;
+					i++;
+					j++;
+				}
+			}
+		}
+
+		return (double)(2 * matches)/(double)lensum;
+	}
+
+	//---------------------------------------------------------------------------
+
+	/* Upper bound of quick_ratio() from the lengths alone (difflib's
+	*   real_quick_ratio)
+	*/
+	template <typename CharT , typename String>
+	double BasicSequenceMatcher<CharT,String>::real_quick_ratio ( void )
+	{
+		size_t lensum = _str1.length() + _str2.length();
+
+		if ( lensum == 0 )
+			return 1.0;
+
+		size_t shorter = _str1.length() < _str2.length() ? _str1.length() : _str2.length();
+
+		return (double)(2 * shorter)/(double)lensum;
+	}
+
+	//---------------------------------------------------------------------------
+
+	template <typename CharT , typename String>
+	int BasicSequenceMatcher<CharT,String>::distance ( void )
 	{
 		if ( _distance == -1 )
 		{
@@ -170,4 +260,11 @@ namespace FuzzyWuzzy
 
 	//---------------------------------------------------------------------------
 
+	template class BasicSequenceMatcher<char>;
+	template class BasicSequenceMatcher<char16_t>;
+	template class BasicSequenceMatcher<char32_t>;
+	template class BasicSequenceMatcher< char     , std::string_view    >;
+	template class BasicSequenceMatcher< char16_t , std::u16string_view >;
+	template class BasicSequenceMatcher< char32_t , std::u32string_view >;
+
 }
@@ -2,6 +2,7 @@
 #define StringMatcherH
 
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace FuzzyWuzzy
@@ -23,30 +24,62 @@ namespace FuzzyWuzzy
 
 	//---------------------------------------------------------------------------
 
-	class SequenceMatcher
+	/* SequenceMatcher compares bytes, the U16 and U32 variants UTF-16 code
+	*   units and code points (see Unicode.h). The matchers copy their inputs.
+	*   The View variants only view them, which saves the copies when the
+	*   strings are known to outlive the matcher: they must be chosen
+	*   explicitly.
+	*/
+	template <typename CharT , typename String = std::basic_string<CharT> >
+	class BasicSequenceMatcher
 	{
 	private :
 
-		std::string          _str1  , _str2;
+		typedef std::basic_string_view<CharT> View;
+
+		String               _str1  , _str2;
 		double               _ratio , _distance;
-		std::vector<Triple>* _matching_blocks;
+		std::vector<Triple>  _matching_blocks;
+		bool                 _has_matching_blocks;
 
 		void _reset_cache ( void );
 
-		static int Levenshtein ( const std::string& s1 , const std::string& str2 , int cost );
+		static int Levenshtein ( View s1 , View str2 , int cost );
+		static int Levenshtein ( View s1 , View str2 , int cost , size_t max );
 
 	public:
 
-		SequenceMatcher ( const std::string& str1 , const std::string& str2 );
-		virtual ~SequenceMatcher ( void );
+		BasicSequenceMatcher ( const String& str1 , const String& str2 );
+		virtual ~BasicSequenceMatcher ( void );
 		
 		std::vector<Triple>* get_matching_blocks ( void );
 
 
-		double ratio    ( void );
-		int    distance ( void );
+		double ratio            ( void );
+		double ratio            ( double score_cutoff );
+		double quick_ratio      ( void );
+		double real_quick_ratio ( void );
+		int    distance         ( void );
 	};
 
+	template <typename CharT>
+	using BasicSequenceMatcherView = BasicSequenceMatcher< CharT , std::basic_string_view<CharT> >;
+
+	typedef BasicSequenceMatcher<char>         SequenceMatcher;
+	typedef BasicSequenceMatcher<char16_t>     U16SequenceMatcher;
+	typedef BasicSequenceMatcher<char32_t>     U32SequenceMatcher;
+
+	typedef BasicSequenceMatcherView<char>     SequenceMatcherView;
+	typedef BasicSequenceMatcherView<char16_t> U16SequenceMatcherView;
+	typedef BasicSequenceMatcherView<char32_t> U32SequenceMatcherView;
+
+	extern template class BasicSequenceMatcher<char>;
+	extern template class BasicSequenceMatcher<char16_t>;
+	extern template class BasicSequenceMatcher<char32_t>;
+	extern template class BasicSequenceMatcher< char     , std::string_view    >;
+	extern template class BasicSequenceMatcher< char16_t , std::u16string_view >;
+	extern template class BasicSequenceMatcher< char32_t , std::u32string_view >;
+
 }
 
 #endif
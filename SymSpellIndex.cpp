@@ -0,0 +1,272 @@
+#include "SymSpellIndex.h"
+#include "Levenshtein.h"
+#include <algorithm>
+#include <utility>
+
+namespace FuzzyWuzzy
+{
+	//---------------------------------------------------------------------------
+
+	static inline uint32_t _code ( char ch )     { return (unsigned char) ch; }
+	static inline uint32_t _code ( char16_t ch ) { return ch; }
+	static inline uint32_t _code ( char32_t ch ) { return ch; }
+
+	/* FNV-1a over the characters, never 0 since that marks a free slot */
+	template <typename CharT>
+	static uint64_t _variant_hash ( const std::basic_string<CharT>& s )
+	{
+		uint64_t h = 0xcbf29ce484222325ULL;
+
+		for ( size_t i = 0 ; i < s.length() ; i++ )
+		{
+			h ^= _code ( s[i] );
+			h *= 0x100000001b3ULL;
+		}
+
+		return h == 0 ? 1 : h;
+	}
+
+	/* Appends the hashes of s and of what deleting up to k of its characters
+	*   at positions >= start leaves. Deleting the second of two equal
+	*   characters leaves the same string as the first, so only the first is
+	*   tried.
+	*/
+	template <typename CharT>
+	static void _deletions ( std::basic_string<CharT>& s , size_t start , size_t k , std::vector<uint64_t>& hashes )
+	{
+		hashes.push_back ( _variant_hash ( s ) );
+
+		if ( k == 0 )
+			return;
+
+		for ( size_t i = start ; i < s.length() ; i++ )
+		{
+			if ( i > start && s[i] == s[i - 1] )
+				continue;
+
+			CharT ch = s[i];
+
+			s.erase ( i , 1 );
+			_deletions ( s , i , k - 1 , hashes );
+			s.insert ( i , 1 , ch );
+		}
+	}
+
+	/* The distinct deletion variants of the prefix of str, sorted */
+	template <typename CharT>
+	static void _variants ( std::basic_string_view<CharT> str , size_t k , size_t prefix_length ,
+							std::basic_string<CharT>& buffer , std::vector<uint64_t>& hashes )
+	{
+		if ( prefix_length != 0 && str.length() > prefix_length )
+			str = str.substr ( 0 , prefix_length );
+
+		buffer.assign ( str.data() , str.length() );
+		hashes.clear();
+
+		_deletions ( buffer , 0 , k , hashes );
+
+		std::sort ( hashes.begin() , hashes.end() );
+		hashes.erase ( std::unique ( hashes.begin() , hashes.end() ) , hashes.end() );
+	}
+
+	//---------------------------------------------------------------------------
+
+	template <typename CharT>
+	BasicSymSpellIndex<CharT>::BasicSymSpellIndex ( const std::vector<String>& terms , size_t max_distance , size_t prefix_length ) :
+		_max_distance ( max_distance ) ,
+		_prefix_length ( prefix_length )
+	{
+		_build ( terms , NULL );
+	}
+
+	template <typename CharT>
+	BasicSymSpellIndex<CharT>::BasicSymSpellIndex ( ThreadPool& pool , const std::vector<String>& terms ,
+													size_t max_distance , size_t prefix_length ) :
+		_max_distance ( max_distance ) ,
+		_prefix_length ( prefix_length )
+	{
+		_build ( terms , &pool );
+	}
+
+	//---------------------------------------------------------------------------
+
+	template <typename CharT>
+	size_t BasicSymSpellIndex<CharT>::_slot ( uint64_t key ) const
+	{
+		size_t mask = _keys.size() - 1;
+		size_t i    = (size_t) ( ( key * 0x9E3779B97F4A7C15ULL ) >> 32 ) & mask;
+
+		while ( _keys[i] != 0 && _keys[i] != key )
+			i = ( i + 1 ) & mask;
+
+		return i;
+	}
+
+	template <typename CharT>
+	void BasicSymSpellIndex<CharT>::_build ( const std::vector<String>& terms , ThreadPool* pool )
+	{
+		typedef std::pair<uint64_t,uint32_t> Posting;
+
+		const size_t CHUNK   = 1024;
+		const size_t BUCKETS = 256;     /* by the top byte of the hash */
+
+		size_t threads = pool ? pool->size() : 1;
+		auto   run     = [&] ( size_t count , const std::function<void(size_t,size_t)>& task )
+		{
+			if ( pool )
+				pool->parallel_for ( count , task );
+			else
+				for ( size_t i = 0 ; i < count ; i++ )
+					task ( i , 0 );
+		};
+
+		size_t chars = 0;
+
+		for ( const String& term : terms )
+			chars += term.length();
+
+		_arena.reserve ( chars );
+		_offsets.assign ( 1 , 0 );
+		_offsets.reserve ( terms.size() + 1 );
+
+		for ( const String& term : terms )
+		{
+			_arena += term;
+			_offsets.push_back ( _arena.length() );
+		}
+
+		// the variants of every term, per worker
+		std::vector< std::vector<Posting> > found ( threads );
+
+		run ( ( terms.size() + CHUNK - 1 ) / CHUNK , [&] ( size_t chunk , size_t worker )
+		{
+			String                buffer;
+			std::vector<uint64_t> hashes;
+			size_t                end = std::min ( terms.size() , ( chunk + 1 ) * CHUNK );
+
+			for ( size_t id = chunk * CHUNK ; id < end ; id++ )
+			{
+				_variants ( View ( terms[id] ) , _max_distance , _prefix_length , buffer , hashes );
+
+				for ( uint64_t h : hashes )
+					found[worker].push_back ( Posting ( h , (uint32_t) id ) );
+			}
+		});
+
+		// scattered into buckets that sort independently
+		std::vector<size_t> bucket_start ( BUCKETS + 1 , 0 );
+
+		for ( const std::vector<Posting>& part : found )
+			for ( const Posting& p : part )
+				bucket_start[( p.first >> 56 ) + 1]++;
+		for ( size_t b = 0 ; b < BUCKETS ; b++ )
+			bucket_start[b + 1] += bucket_start[b];
+
+		std::vector<Posting> postings ( bucket_start[BUCKETS] );
+		std::vector<size_t>  fill ( bucket_start.begin() , bucket_start.end() - 1 );
+
+		for ( std::vector<Posting>& part : found )
+		{
+			for ( const Posting& p : part )
+				postings[fill[p.first >> 56]++] = p;
+
+			std::vector<Posting>().swap ( part );
+		}
+
+		run ( BUCKETS , [&] ( size_t b , size_t )
+		{
+			std::sort ( postings.begin() + bucket_start[b] , postings.begin() + bucket_start[b + 1] );
+		});
+
+		// one group of ids per distinct variant
+		size_t distinct = 0;
+
+		for ( size_t i = 0 ; i < postings.size() ; i++ )
+			distinct += i == 0 || postings[i].first != postings[i - 1].first;
+
+		size_t slots = 16;
+
+		while ( slots < 2 * distinct )
+			slots *= 2;
+
+		_keys.assign ( slots , 0 );
+		_groups.assign ( slots , 0 );
+		_group_start.clear();
+		_group_start.reserve ( distinct + 1 );
+		_ids.resize ( postings.size() );
+
+		for ( size_t i = 0 ; i < postings.size() ; i++ )
+		{
+			if ( i == 0 || postings[i].first != postings[i - 1].first )
+			{
+				size_t slot = _slot ( postings[i].first );
+
+				_keys[slot]   = postings[i].first;
+				_groups[slot] = (uint32_t) _group_start.size();
+				_group_start.push_back ( (uint32_t) i );
+			}
+
+			_ids[i] = postings[i].second;
+		}
+
+		_group_start.push_back ( (uint32_t) postings.size() );
+	}
+
+	//---------------------------------------------------------------------------
+
+	template <typename CharT>
+	void BasicSymSpellIndex<CharT>::find ( View query , size_t k , std::vector<SymSpellMatch>& matches ) const
+	{
+		static thread_local String                buffer;
+		static thread_local std::vector<uint64_t> hashes;
+		static thread_local std::vector<uint32_t> hits;
+
+		matches.clear();
+
+		// the variants of larger distances are not indexed
+		k = std::min ( k , _max_distance );
+
+		_variants ( query , k , _prefix_length , buffer , hashes );
+		hits.clear();
+
+		for ( uint64_t h : hashes )
+		{
+			size_t slot = _slot ( h );
+
+			if ( _keys[slot] == 0 )
+				continue;
+
+			uint32_t group = _groups[slot];
+
+			hits.insert ( hits.end() , _ids.begin() + _group_start[group] , _ids.begin() + _group_start[group + 1] );
+		}
+
+		std::sort ( hits.begin() , hits.end() );
+		hits.erase ( std::unique ( hits.begin() , hits.end() ) , hits.end() );
+
+		for ( uint32_t id : hits )
+		{
+			View             other = term ( id );
+			size_t           ldiff = query.length() > other.length() ? query.length() - other.length() : other.length() - query.length();
+
+			if ( ldiff > k )
+				continue;
+
+			size_t d = lev_edit_distance ( query.length() , query.data() , other.length() , other.data() , 0 , k );
+
+			if ( d <= k )
+				matches.push_back ( { id , d } );
+		}
+
+		std::sort ( matches.begin() , matches.end() , [] ( const SymSpellMatch& a , const SymSpellMatch& b )
+		{
+			return a.distance != b.distance ? a.distance < b.distance : a.id < b.id;
+		});
+	}
+
+	//---------------------------------------------------------------------------
+
+	template class BasicSymSpellIndex<char>;
+	template class BasicSymSpellIndex<char16_t>;
+	template class BasicSymSpellIndex<char32_t>;
+}
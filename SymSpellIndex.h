@@ -0,0 +1,96 @@
+#ifndef SymSpellIndexH
+#define SymSpellIndexH
+
+#include "ThreadPool.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace FuzzyWuzzy
+{
+	struct SymSpellMatch
+	{
+		size_t id;         /* index in the term list */
+		size_t distance;
+	};
+
+	//---------------------------------------------------------------------------
+
+	/* Symmetric delete index (SymSpell) for terms within a small Levenshtein
+	*   distance of a query. Two strings within k edits leave a common string
+	*   after at most k deletions each, so the index maps the hash of every
+	*   string left by up to max_distance deletions from a term to the ids of
+	*   the terms leaving it. A query looks up its own deletion variants and
+	*   verifies the hits with lev_edit_distance.
+	*
+	*   Only the first prefix_length characters of the terms and of the queries are
+	*   deleted from (0 takes whole strings), which still finds every match:
+	*   a shorter prefix means fewer variants, less memory and a faster build,
+	*   and more hits to verify. The terms are copied.
+	*
+	*   The variants of a term hash into an open addressing table of 64 bit
+	*   keys, at most half full, each slot holding a range of a flat id list.
+	*   find may run on several threads at once.
+	*
+	*   CharT is the character of lev_edit_distance: SymSpellIndex deletes and
+	*   counts bytes, U16SymSpellIndex UTF-16 code units and U32SymSpellIndex
+	*   code points.
+	*/
+	template <typename CharT>
+	class BasicSymSpellIndex
+	{
+	public:
+
+		typedef std::basic_string<CharT>      String;
+		typedef std::basic_string_view<CharT> View;
+
+	private :
+
+		String                _arena;
+		std::vector<size_t>   _offsets;       /* term i is _arena[_offsets[i] .. _offsets[i + 1]) */
+		size_t                _max_distance;
+		size_t                _prefix_length;
+
+		std::vector<uint64_t> _keys;          /* 0 marks a free slot */
+		std::vector<uint32_t> _groups;        /* by slot, ids are _ids[_group_start[g] .. _group_start[g + 1]) */
+		std::vector<uint32_t> _group_start;
+		std::vector<uint32_t> _ids;
+
+		void   _build ( const std::vector<String>& terms , ThreadPool* pool );
+		size_t _slot  ( uint64_t key ) const;
+
+	public:
+
+		BasicSymSpellIndex ( const std::vector<String>& terms , size_t max_distance = 2 , size_t prefix_length = 7 );
+
+		/* Same index, the deletion variants generated and sorted on the threads of pool */
+		BasicSymSpellIndex ( ThreadPool& pool , const std::vector<String>& terms ,
+							 size_t max_distance = 2 , size_t prefix_length = 7 );
+
+		size_t size         ( void )      const { return _offsets.size() - 1; }
+		View   term         ( size_t id ) const { return View ( _arena ).substr ( _offsets[id] , _offsets[id + 1] - _offsets[id] ); }
+		size_t max_distance ( void )      const { return _max_distance; }
+
+		// number of distinct deletion variants and of ids in their lists
+		size_t variant_count ( void ) const { return _group_start.empty() ? 0 : _group_start.size() - 1; }
+		size_t posting_count ( void ) const { return _ids.size(); }
+
+		/* The terms within k edits of query into matches, by distance and then
+		*   by id. The index only holds the variants of max_distance() deletions:
+		*   a larger k is lowered to max_distance(), it does not find more.
+		*/
+		void find ( View query , size_t k , std::vector<SymSpellMatch>& matches ) const;
+	};
+
+	typedef BasicSymSpellIndex<char>     SymSpellIndex;
+	typedef BasicSymSpellIndex<char16_t> U16SymSpellIndex;
+	typedef BasicSymSpellIndex<char32_t> U32SymSpellIndex;
+
+	extern template class BasicSymSpellIndex<char>;
+	extern template class BasicSymSpellIndex<char16_t>;
+	extern template class BasicSymSpellIndex<char32_t>;
+}
+
+#endif
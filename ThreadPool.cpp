@@ -0,0 +1,168 @@
+#include "ThreadPool.h"
+
+namespace FuzzyWuzzy
+{
+	ThreadPool::ThreadPool ( size_t threads )
+	{
+		if ( threads == 0 )
+			threads = std::thread::hardware_concurrency();
+
+		if ( threads == 0 )
+			threads = 1;
+
+		_task       = NULL;
+		_generation = 0;
+		_active     = 0;
+		_pending    = 0;
+		_stop       = false;
+
+		for ( size_t i = 0; i < threads; ++i )
+			_queues.push_back ( std::unique_ptr<Queue> ( new Queue() ) );
+
+		for ( size_t i = 0; i < threads; ++i )
+			_threads.push_back ( std::thread ( &ThreadPool::_worker , this , i ) );
+	}
+
+	//---------------------------------------------------------------------------
+
+	ThreadPool::~ThreadPool ( void )
+	{
+		{
+			std::lock_guard<std::mutex> guard ( _lock );
+			_stop = true;
+		}
+
+		_wake.notify_all();
+
+		for ( size_t i = 0; i < _threads.size(); ++i )
+			_threads[i].join();
+	}
+
+	//---------------------------------------------------------------------------
+
+	bool ThreadPool::_pop ( size_t worker , size_t& index )
+	{
+		size_t count = _queues.size();
+
+		for ( size_t i = 0; i < count; ++i )
+		{
+			Queue& queue = *_queues[( worker + i ) % count];
+
+			std::lock_guard<std::mutex> guard ( queue.lock );
+
+			if ( queue.tasks.empty() )
+				continue;
+
+			// own work in order, stolen work from the other end
+			if ( i == 0 )
+			{
+				index = queue.tasks.front();
+				queue.tasks.pop_front();
+			}
+			else
+			{
+				index = queue.tasks.back();
+				queue.tasks.pop_back();
+			}
+
+			return true;
+		}
+
+		return false;
+	}
+
+	//---------------------------------------------------------------------------
+
+	void ThreadPool::_worker ( size_t worker )
+	{
+		size_t seen = 0;
+
+		for (;;)
+		{
+			const std::function<void(size_t,size_t)>* task;
+
+			{
+				std::unique_lock<std::mutex> guard ( _lock );
+
+				_wake.wait ( guard , [&] { return _stop || _generation != seen; } );
+
+				if ( _stop )
+					return;
+
+				seen = _generation;
+				task = _task;
+				++_active;
+			}
+
+			size_t index;
+
+			while ( task != NULL && _pop ( worker , index ) )
+			{
+				try
+				{
+					(*task) ( index , worker );
+				}
+				catch ( ... )
+				{
+					std::lock_guard<std::mutex> guard ( _lock );
+
+					if ( !_error )
+						_error = std::current_exception();
+				}
+
+				--_pending;
+			}
+
+			{
+				std::lock_guard<std::mutex> guard ( _lock );
+
+				if ( --_active == 0 )
+					_done.notify_all();
+			}
+		}
+	}
+
+	//---------------------------------------------------------------------------
+
+	void ThreadPool::parallel_for ( size_t count , const std::function<void(size_t,size_t)>& task )
+	{
+		if ( count == 0 )
+			return;
+
+		std::lock_guard<std::mutex> loop_guard ( _loop );
+
+		size_t             workers = _queues.size();
+		std::exception_ptr error;
+
+		{
+			std::unique_lock<std::mutex> guard ( _lock );
+
+			// workers that woke up late for the previous loop must be gone
+			_done.wait ( guard , [&] { return _active == 0; } );
+
+			// contiguous runs of indices per worker keep neighbouring work together
+			for ( size_t w = 0; w < workers; ++w )
+			{
+				std::lock_guard<std::mutex> queue_guard ( _queues[w]->lock );
+
+				for ( size_t i = count * w / workers; i < count * ( w + 1 ) / workers; ++i )
+					_queues[w]->tasks.push_back ( i );
+			}
+
+			_task    = &task;
+			_pending = count;
+			_error   = NULL;
+			++_generation;
+
+			_wake.notify_all();
+
+			_done.wait ( guard , [&] { return _pending == 0 && _active == 0; } );
+
+			_task = NULL;
+			error = _error;
+		}
+
+		if ( error )
+			std::rethrow_exception ( error );
+	}
+}
@@ -0,0 +1,81 @@
+#ifndef ThreadPoolH
+#define ThreadPoolH
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace FuzzyWuzzy
+{
+	/* Fixed set of worker threads running parallel loops. Every worker owns a
+	*   queue of loop indices: it takes its own work from the front and, once
+	*   that runs dry, steals from the back of the other queues.
+	*
+	*   Several threads may share a pool: their parallel_for calls run one
+	*   after the other. parallel_for must not be called from inside one of
+	*   its own tasks.
+	*/
+	class ThreadPool
+	{
+	private :
+
+		struct Queue
+		{
+			std::mutex         lock;
+			std::deque<size_t> tasks;
+		};
+
+		std::vector<std::thread>            _threads;
+		std::vector<std::unique_ptr<Queue>> _queues;
+
+		std::mutex                          _loop;   /* held by the running parallel_for */
+		std::mutex                          _lock;
+		std::condition_variable             _wake , _done;
+		const std::function<void(size_t,size_t)>* _task;
+		size_t                              _generation;
+		size_t                              _active;
+		std::atomic<size_t>                 _pending;
+		std::exception_ptr                  _error;
+		bool                                _stop;
+
+		bool _pop    ( size_t worker , size_t& index );
+		void _worker ( size_t worker );
+
+	public:
+
+		// threads == 0 uses one thread per hardware thread
+		explicit ThreadPool ( size_t threads = 0 );
+		virtual ~ThreadPool ( void );
+
+		size_t size ( void ) const { return _threads.size(); }
+
+		/* Runs task ( index , worker ) for every index in [0, count) and
+		*   waits for all of them. worker is in [0, size()), so callers can
+		*   keep per-worker state without locking. The first exception thrown
+		*   by a task is rethrown here once the loop is over. A call from
+		*   another thread waits for the running loop to finish.
+		*/
+		void parallel_for ( size_t count , const std::function<void(size_t,size_t)>& task );
+	};
+
+	//---------------------------------------------------------------------------
+
+	/* raises target to value unless it already is larger */
+	inline void atomic_max ( std::atomic<double>& target , double value )
+	{
+		double current = target.load ( std::memory_order_relaxed );
+
+		while ( current < value &&
+				!target.compare_exchange_weak ( current , value , std::memory_order_relaxed ) )
+		{
+		}
+	}
+}
+
+#endif
@@ -0,0 +1,279 @@
+#include "TokenIndex.h"
+#include <algorithm>
+#include <numeric>
+#include <utility>
+
+namespace FuzzyWuzzy
+{
+	//---------------------------------------------------------------------------
+
+	/* the distinct tokens of s, sorted */
+	static void _token_set_views ( const std::string& s , std::vector<TokenSpan>& spans , std::vector<std::string_view>& views )
+	{
+		find_tokens ( s.data() , s.length() , spans );
+
+		views.clear();
+
+		for ( std::vector<TokenSpan>::const_iterator it = spans.begin(); it != spans.end(); ++it )
+			views.push_back ( std::string_view ( s.data() + it->offset , it->length ) );
+
+		std::sort ( views.begin() , views.end() );
+		views.erase ( std::unique ( views.begin() , views.end() ) , views.end() );
+	}
+
+	/* a token weighs its length and the space joining it to the next one */
+	static inline uint32_t _token_weight ( std::string_view token )
+	{
+		return (uint32_t) token.length() + 1;
+	}
+
+	/* letters by their lower case, digits by pairs, the rest together */
+	static inline size_t _bucket ( unsigned char ch )
+	{
+		unsigned char lower = ch | 0x20;
+
+		if ( lower >= 'a' && lower <= 'z' )
+			return lower - 'a';
+		if ( ch >= '0' && ch <= '9' )
+			return 26 + ( ch - '0' ) / 2;
+
+		return TokenIndex::BUCKETS - 1;
+	}
+
+	/* character counts of the token set joined by spaces into histogram,
+	*   UINT8_MAX standing for any larger count
+	*/
+	static void _histogram ( const std::vector<std::string_view>& views , uint8_t* histogram )
+	{
+		std::fill ( histogram , histogram + TokenIndex::BUCKETS , 0 );
+
+		auto add = [&] ( unsigned char ch )
+		{
+			uint8_t& count = histogram[_bucket ( ch )];
+
+			if ( count < UINT8_MAX )
+				count++;
+		};
+
+		for ( size_t i = 0 ; i < views.size() ; i++ )
+		{
+			if ( i != 0 )
+				add ( ' ' );
+
+			for ( char ch : views[i] )
+				add ( (unsigned char) ch );
+		}
+	}
+
+	//---------------------------------------------------------------------------
+
+	TokenIndex::TokenIndex ( const std::vector<std::string>& choices ) :
+		_choices ( &choices )
+	{
+		std::vector<TokenSpan>        spans;
+		std::vector<std::string_view> views;
+		std::vector<uint32_t>         tokens;           /* dictionary ids of the choices' token sets */
+		std::vector<size_t>           token_start ( 1 , 0 );
+		std::vector<uint32_t>         frequency;        /* by dictionary id */
+		std::vector<uint8_t>          histograms ( choices.size() * BUCKETS );
+
+		_weights.resize ( choices.size() );
+
+		for ( size_t id = 0 ; id < choices.size() ; id++ )
+		{
+			_token_set_views ( choices[id] , spans , views );
+			_histogram ( views , &histograms[id * BUCKETS] );
+
+			uint32_t weight = 0;
+
+			for ( std::string_view token : views )
+			{
+				uint32_t t = _tokens.intern ( token );
+
+				if ( t == frequency.size() )
+					frequency.push_back ( 0 );
+
+				frequency[t]++;
+				tokens.push_back ( t );
+				weight += _token_weight ( token );
+			}
+
+			_weights[id] = weight;
+			token_start.push_back ( tokens.size() );
+
+			if ( views.empty() )
+				_untokenized.push_back ( (uint32_t) id );
+		}
+
+		// rarest first, ties by token
+		std::vector<uint32_t> order ( _tokens.size() );
+
+		std::iota ( order.begin() , order.end() , 0 );
+		std::sort ( order.begin() , order.end() , [&] ( uint32_t a , uint32_t b )
+		{
+			return frequency[a] != frequency[b] ? frequency[a] < frequency[b] : _tokens.token ( a ) < _tokens.token ( b );
+		});
+
+		_rank.resize ( order.size() );
+		_frequency.resize ( order.size() );
+
+		for ( uint32_t r = 0 ; r < order.size() ; r++ )
+		{
+			_rank[order[r]] = r;
+			_frequency[r]   = frequency[order[r]];
+		}
+
+		// one list per rank, the choices added lightest first
+		_posting_start.assign ( order.size() + 1 , 0 );
+
+		for ( uint32_t t : tokens )
+			_posting_start[_rank[t] + 1]++;
+		for ( size_t r = 0 ; r < order.size() ; r++ )
+			_posting_start[r + 1] += _posting_start[r];
+
+		std::vector<uint32_t> fill ( _posting_start.begin() , _posting_start.end() - 1 );
+		std::vector< std::pair<uint32_t,uint32_t> > ranked;   /* rank , weight */
+
+		_by_weight.resize ( choices.size() );
+		std::iota ( _by_weight.begin() , _by_weight.end() , 0 );
+		std::stable_sort ( _by_weight.begin() , _by_weight.end() , [&] ( uint32_t a , uint32_t b ) { return _weights[a] < _weights[b]; } );
+
+		_ordered_weights.resize ( choices.size() );
+		_histograms.resize ( histograms.size() );
+
+		for ( size_t i = 0 ; i < choices.size() ; i++ )
+		{
+			_ordered_weights[i] = _weights[_by_weight[i]];
+			std::copy_n ( &histograms[_by_weight[i] * BUCKETS] , BUCKETS , &_histograms[i * BUCKETS] );
+		}
+
+		_postings.resize ( tokens.size() );
+
+		for ( uint32_t id : _by_weight )
+		{
+			ranked.clear();
+
+			for ( size_t i = token_start[id] ; i < token_start[id + 1] ; i++ )
+				ranked.push_back ( std::make_pair ( _rank[tokens[i]] , _token_weight ( _tokens.token ( tokens[i] ) ) ) );
+
+			std::sort ( ranked.begin() , ranked.end() );
+
+			uint32_t suffix = _weights[id];
+
+			for ( const std::pair<uint32_t,uint32_t>& t : ranked )
+			{
+				_postings[fill[t.first]++] = { id , suffix };
+				suffix -= t.second;
+			}
+		}
+	}
+
+	//---------------------------------------------------------------------------
+
+	uint32_t TokenIndex::rank ( std::string_view token ) const
+	{
+		uint32_t t = _tokens.find ( token );
+
+		return t == TokenDictionary::npos ? TokenDictionary::npos : _rank[t];
+	}
+
+	//---------------------------------------------------------------------------
+
+	void TokenIndex::candidates ( const std::string& query , double score_cutoff , std::vector<uint32_t>& ids ) const
+	{
+		static thread_local std::vector<TokenSpan>                     spans;
+		static thread_local std::vector<std::string_view>              views;
+		static thread_local std::vector< std::pair<uint32_t,uint32_t> > shared;   /* rank , weight */
+		static thread_local std::vector<uint8_t>                       histogram;
+
+		ids.clear();
+		if ( score_cutoff > 100 )
+			return;
+
+		_token_set_views ( query , spans , views );
+
+		// a query without tokens scores 100 against everything
+		if ( score_cutoff <= 0 || views.empty() )
+		{
+			ids.resize ( size() );
+			std::iota ( ids.begin() , ids.end() , 0 );
+			return;
+		}
+
+		uint32_t weight1   = 0;
+		uint32_t remaining = 0;
+
+		shared.clear();
+
+		for ( std::string_view token : views )
+		{
+			uint32_t r = rank ( token );
+
+			weight1 += _token_weight ( token );
+
+			if ( r != TokenDictionary::npos )
+			{
+				shared.push_back ( std::make_pair ( r , _token_weight ( token ) ) );
+				remaining += _token_weight ( token );
+			}
+		}
+
+		std::sort ( shared.begin() , shared.end() );
+
+		// the weight to share with a choice when the lighter set weighs w,
+		// lowered a little so that rounding never drops a tie
+		double r     = score_cutoff / 100.0;
+		double alpha = r / ( 2.0 - r );
+		auto   need  = [&] ( uint32_t w ) { return 1.0 + alpha * ( (double) w - 1.0 ) - 1e-7; };
+
+		for ( const std::pair<uint32_t,uint32_t>& token : shared )
+		{
+			// the choices first met here share at most remaining
+			double max_weight = need ( weight1 ) <= remaining ? (double) UINT32_MAX :
+								1.0 + ( (double) remaining - 1.0 ) / alpha + 1e-7;
+
+			for ( uint32_t i = _posting_start[token.first] ; i < _posting_start[token.first + 1] ; i++ )
+			{
+				const Posting& p       = _postings[i];
+				uint32_t       weight2 = _weights[p.id];
+
+				if ( weight2 > max_weight )
+					break;
+
+				if ( std::min ( remaining , p.suffix ) >= need ( std::min ( weight1 , weight2 ) ) )
+					ids.push_back ( p.id );
+			}
+
+			remaining -= token.second;
+		}
+
+		// the choices whose combined strings may still be close enough, from
+		// their lengths and then from their characters
+		histogram.resize ( BUCKETS );
+		_histogram ( views , histogram.data() );
+
+		// below UINT8_MAX the query's counts are exact, and so is their
+		// minimum with any count of a choice
+		bool   full     = std::find ( histogram.begin() , histogram.end() , UINT8_MAX ) != histogram.end();
+		double length1  = weight1 - 1;
+		double shortest = alpha * length1 + 1.0 - 1e-7;
+		double longest  = length1 / alpha + 1.0 + 1e-7;
+		size_t i        = std::lower_bound ( _ordered_weights.begin() , _ordered_weights.end() , shortest ) - _ordered_weights.begin();
+
+		for ( const uint8_t* histogram2 = _histograms.data() + i * BUCKETS ; i < size() && _ordered_weights[i] <= longest ; i++ , histogram2 += BUCKETS )
+		{
+			uint32_t common = 0;
+
+			for ( size_t b = 0 ; b < BUCKETS ; b++ )
+				common += std::min ( histogram[b] , histogram2[b] );
+
+			if ( full || 200.0 * common >= ( score_cutoff - 1e-7 ) * ( length1 + _ordered_weights[i] - 1 ) )
+				ids.push_back ( _by_weight[i] );
+		}
+
+		ids.insert ( ids.end() , _untokenized.begin() , _untokenized.end() );
+
+		std::sort ( ids.begin() , ids.end() );
+		ids.erase ( std::unique ( ids.begin() , ids.end() ) , ids.end() );
+	}
+}
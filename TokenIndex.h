@@ -0,0 +1,103 @@
+#ifndef TokenIndexH
+#define TokenIndexH
+
+#include "Tokenizer.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace FuzzyWuzzy
+{
+	/* Inverted index from the tokens of a list of choices (see find_tokens)
+	*   to the choices containing them, to find the choices whose token set
+	*   ratio with a query can reach a cutoff.
+	*
+	*   token_set_ratio is the best of the ratios of the joined intersection
+	*   to the two joined token sets, 100 when one set holds the other, and of
+	*   the ratio between the two joined token sets. A token weighs its length
+	*   plus the separator, so with r the cutoff (0..1) the first ones reach
+	*   it when the weight a choice shares with the query reaches
+	*   1 + r / ( 2 - r ) * ( min ( Wq , Wc ) - 1 ), the W being the weights
+	*   of the two token sets.
+	*
+	*   Token ids rank the tokens by document frequency, rarest first, and the
+	*   tokens of every choice and query are taken in that order. A choice
+	*   sharing enough weight shares a token early enough for the rest of the
+	*   query to make up the weight (prefix filtering), with the weight of the
+	*   choice from that token on as a second bound (positional filtering).
+	*   The posting lists are ordered by choice weight, so a list is cut as
+	*   soon as its choices are too heavy for what is left of the query (size
+	*   filtering).
+	*
+	*   The ratio of the joined token sets can reach the cutoff with no token
+	*   shared, typos in every token. Its common subsequence is at most the
+	*   shorter string and at most the characters the two have in common, so
+	*   the choices of a weight between r / ( 2 - r ) and ( 2 - r ) / r times
+	*   that of the query, a range of the choices sorted by weight, are
+	*   checked against a histogram of their characters in BUCKETS buckets.
+	*   No choice reaching the cutoff is dropped.
+	*
+	*   token_sort_ratio compares the joined sorted tokens character by
+	*   character: a QGramIndex over TokenizedString::sorted() serves it.
+	*
+	*   The tokens are those of find_tokens on bytes, where letters above
+	*   ASCII split tokens, and the weights count bytes: the index filters
+	*   for CachedTokenSetRatio, not for the code points of the utf8::
+	*   scorers. MinHashLSH has std::u32string overloads for those.
+	*
+	*   The choices are not copied: they must outlive the index. Queries do not
+	*   change the index and may run on several threads at once.
+	*/
+	class TokenIndex
+	{
+	public:
+
+		static const size_t BUCKETS = 32;
+
+	private :
+
+		struct Posting
+		{
+			uint32_t id;
+			uint32_t suffix;     /* weight of the choice from this token on */
+		};
+
+		const std::vector<std::string>* _choices;
+
+		TokenDictionary                 _tokens;
+		std::vector<uint32_t>           _rank;            /* by dictionary id */
+		std::vector<uint32_t>           _frequency;       /* by rank */
+		std::vector<uint32_t>           _weights;         /* by choice */
+		std::vector<uint32_t>           _untokenized;     /* choices without tokens, they score 100 */
+		std::vector<uint32_t>           _by_weight;       /* choices, lightest first */
+		std::vector<uint32_t>           _ordered_weights; /* in _by_weight order */
+		std::vector<uint8_t>            _histograms;      /* BUCKETS counts in _by_weight order, full at UINT8_MAX */
+
+		std::vector<uint32_t>           _posting_start;   /* by rank */
+		std::vector<Posting>            _postings;
+
+	public:
+
+		TokenIndex ( const std::vector<std::string>& choices );
+
+		size_t                          size    ( void )      const { return _choices->size(); }
+		const std::string&              choice  ( size_t id ) const { return (*_choices)[id]; }
+		const std::vector<std::string>& choices ( void )      const { return *_choices; }
+
+		size_t                          token_count ( void ) const { return _tokens.size(); }
+
+		/* The rank of token, rarest first, npos when no choice has it */
+		uint32_t                        rank      ( std::string_view token ) const;
+		/* The number of choices holding the token of a rank */
+		uint32_t                        frequency ( uint32_t rank ) const { return _frequency[rank]; }
+
+		/* The ids of the choices that may reach score_cutoff with query, in
+		*   increasing order. They include every choice that does, and still
+		*   have to be scored.
+		*/
+		void candidates ( const std::string& query , double score_cutoff , std::vector<uint32_t>& ids ) const;
+	};
+}
+
+#endif
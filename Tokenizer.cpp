@@ -0,0 +1,322 @@
+#include "Tokenizer.h"
+#include "Unicode.h"
+#include <algorithm>
+
+#if defined(__GNUC__) && ( defined(__x86_64__) || defined(__i386__) )
+#define FUZZYWUZZY_X86 1
+#include <immintrin.h>
+#endif
+
+namespace FuzzyWuzzy
+{
+	static inline size_t _ctz64 ( uint64_t x )
+	{
+#if defined(__GNUC__) || defined(__clang__)
+		return (size_t) __builtin_ctzll ( x );
+#else
+		size_t n = 0;
+		while ( !( x & 1 ) ) { x >>= 1; ++n; }
+		return n;
+#endif
+	}
+
+	//---------------------------------------------------------------------------
+
+	static inline bool _is_token_char ( unsigned char ch )
+	{
+		return ( ch >= '0' && ch <= '9' ) || ( ch >= 'A' && ch <= 'Z' ) ||
+			   ( ch >= 'a' && ch <= 'z' ) || ch == '_';
+	}
+
+	//---------------------------------------------------------------------------
+
+	static uint64_t _token_mask_scalar ( const char* str , size_t len )
+	{
+		uint64_t mask = 0;
+
+		for ( size_t i = 0; i < len; ++i )
+			mask |= (uint64_t) _is_token_char ( (unsigned char) str[i] ) << i;
+
+		return mask;
+	}
+
+	//---------------------------------------------------------------------------
+
+#ifdef FUZZYWUZZY_X86
+
+	/* 'a'-'z' after setting bit 5 (which folds 'A'-'Z'), '0'-'9' and '_'.
+	*   Bytes above 0x7f are negative and fail the signed range checks. */
+	__attribute__((target("sse2")))
+	static inline __m128i _classify16 ( __m128i x )
+	{
+		__m128i lower   = _mm_or_si128 ( x , _mm_set1_epi8 ( 0x20 ) );
+		__m128i letters = _mm_and_si128 ( _mm_cmpgt_epi8 ( lower , _mm_set1_epi8 ( 'a' - 1 ) ) ,
+										  _mm_cmplt_epi8 ( lower , _mm_set1_epi8 ( 'z' + 1 ) ) );
+		__m128i digits  = _mm_and_si128 ( _mm_cmpgt_epi8 ( x , _mm_set1_epi8 ( '0' - 1 ) ) ,
+										  _mm_cmplt_epi8 ( x , _mm_set1_epi8 ( '9' + 1 ) ) );
+		__m128i under   = _mm_cmpeq_epi8 ( x , _mm_set1_epi8 ( '_' ) );
+
+		return _mm_or_si128 ( _mm_or_si128 ( letters , digits ) , under );
+	}
+
+	__attribute__((target("sse2")))
+	static uint64_t _token_mask64_sse2 ( const char* str )
+	{
+		uint64_t mask = 0;
+
+		for ( int i = 0; i < 4; ++i )
+		{
+			__m128i x = _mm_loadu_si128 ( (const __m128i*) ( str + 16 * i ) );
+			mask |= (uint64_t) (uint16_t) _mm_movemask_epi8 ( _classify16 ( x ) ) << ( 16 * i );
+		}
+
+		return mask;
+	}
+
+	__attribute__((target("avx2")))
+	static uint64_t _token_mask64_avx2 ( const char* str )
+	{
+		uint64_t mask = 0;
+
+		for ( int i = 0; i < 2; ++i )
+		{
+			__m256i x       = _mm256_loadu_si256 ( (const __m256i*) ( str + 32 * i ) );
+			__m256i lower   = _mm256_or_si256 ( x , _mm256_set1_epi8 ( 0x20 ) );
+			__m256i letters = _mm256_and_si256 ( _mm256_cmpgt_epi8 ( lower , _mm256_set1_epi8 ( 'a' - 1 ) ) ,
+												 _mm256_cmpgt_epi8 ( _mm256_set1_epi8 ( 'z' + 1 ) , lower ) );
+			__m256i digits  = _mm256_and_si256 ( _mm256_cmpgt_epi8 ( x , _mm256_set1_epi8 ( '0' - 1 ) ) ,
+												 _mm256_cmpgt_epi8 ( _mm256_set1_epi8 ( '9' + 1 ) , x ) );
+			__m256i under   = _mm256_cmpeq_epi8 ( x , _mm256_set1_epi8 ( '_' ) );
+			__m256i word    = _mm256_or_si256 ( _mm256_or_si256 ( letters , digits ) , under );
+
+			mask |= (uint64_t) (uint32_t) _mm256_movemask_epi8 ( word ) << ( 32 * i );
+		}
+
+		return mask;
+	}
+
+#endif
+
+	//---------------------------------------------------------------------------
+
+	typedef uint64_t (*TokenMask64) ( const char* );
+
+	static uint64_t _token_mask64_scalar ( const char* str )
+	{
+		return _token_mask_scalar ( str , 64 );
+	}
+
+	/* picks the widest kernel the CPU supports, once */
+	static TokenMask64 _token_mask64 ( void )
+	{
+#ifdef FUZZYWUZZY_X86
+		static const TokenMask64 kernel = __builtin_cpu_supports ( "avx2" ) ? _token_mask64_avx2 :
+										  __builtin_cpu_supports ( "sse2" ) ? _token_mask64_sse2 :
+																			  _token_mask64_scalar;
+		return kernel;
+#else
+		return _token_mask64_scalar;
+#endif
+	}
+
+	//---------------------------------------------------------------------------
+
+	uint64_t token_mask ( const char* str , size_t len )
+	{
+		return len == 64 ? _token_mask64() ( str ) : _token_mask_scalar ( str , len );
+	}
+
+	//---------------------------------------------------------------------------
+
+	void find_tokens ( const char* str , size_t len , std::vector<TokenSpan>& spans )
+	{
+		TokenMask64 mask64   = _token_mask64();
+		bool        in_token = false;
+		size_t      start    = 0;
+
+		spans.clear();
+
+		for ( size_t base = 0; base < len; base += 64 )
+		{
+			size_t   block = len - base < 64 ? len - base : 64;
+			uint64_t mask  = block == 64 ? mask64 ( str + base ) : _token_mask_scalar ( str + base , block );
+			size_t   pos   = 0;
+
+			// walk the 0->1 and 1->0 transitions of the mask
+			while ( pos < 64 )
+			{
+				if ( !in_token )
+				{
+					uint64_t rest = mask >> pos;
+
+					if ( rest == 0 )
+						break;
+
+					pos     += _ctz64 ( rest );
+					start    = base + pos;
+					in_token = true;
+				}
+
+				uint64_t rest = ~mask >> pos;
+
+				if ( rest == 0 )
+					break;
+
+				pos += _ctz64 ( rest );
+
+				spans.push_back ( { start , base + pos - start } );
+				in_token = false;
+			}
+		}
+
+		if ( in_token )
+			spans.push_back ( { start , len - start } );
+	}
+
+	//---------------------------------------------------------------------------
+
+	template <typename CharT>
+	static void _find_tokens ( const CharT* str , size_t len , std::vector<TokenSpan>& spans )
+	{
+		size_t i = 0;
+
+		spans.clear();
+
+		while ( i < len )
+		{
+			while ( i < len && !unicode_is_word ( str[i] ) )
+				i++;
+
+			size_t start = i;
+
+			while ( i < len && unicode_is_word ( str[i] ) )
+				i++;
+
+			if ( i > start )
+				spans.push_back ( { start , i - start } );
+		}
+	}
+
+	void find_tokens ( const char16_t* str , size_t len , std::vector<TokenSpan>& spans )
+	{
+		_find_tokens ( str , len , spans );
+	}
+
+	void find_tokens ( const char32_t* str , size_t len , std::vector<TokenSpan>& spans )
+	{
+		_find_tokens ( str , len , spans );
+	}
+
+	//---------------------------------------------------------------------------
+	//---------------------------------------------------------------------------
+	//---------------------------------------------------------------------------
+
+	/* FNV-1a on the code units, with the high bits folded in for the slot */
+	template <typename CharT>
+	uint64_t BasicTokenDictionary<CharT>::_hash ( View token )
+	{
+		uint64_t hash = 0xcbf29ce484222325ULL;
+
+		for ( size_t i = 0; i < token.length(); ++i )
+		{
+			hash ^= (uint64_t) token[i];
+			hash *= 0x100000001b3ULL;
+		}
+
+		return hash ^ ( hash >> 29 );
+	}
+
+	//---------------------------------------------------------------------------
+
+	/* the slot holding token, or the free slot where it belongs */
+	template <typename CharT>
+	size_t BasicTokenDictionary<CharT>::_slot ( View token , uint64_t hash ) const
+	{
+		size_t mask = _slots.size() - 1;
+
+		for ( size_t i = hash & mask ; ; i = ( i + 1 ) & mask )
+		{
+			uint32_t slot = _slots[i];
+
+			if ( slot == 0 )
+				return i;
+
+			const Entry& e = _entries[slot - 1];
+
+			if ( e.hash == hash && e.length == token.length() &&
+				 std::char_traits<CharT>::compare ( _arena.data() + e.offset , token.data() , e.length ) == 0 )
+				return i;
+		}
+	}
+
+	//---------------------------------------------------------------------------
+
+	template <typename CharT>
+	void BasicTokenDictionary<CharT>::_grow ( void )
+	{
+		_slots.assign ( _slots.empty() ? 16 : 2 * _slots.size() , 0 );
+
+		size_t mask = _slots.size() - 1;
+
+		for ( size_t id = 0; id < _entries.size(); ++id )
+		{
+			size_t i = _entries[id].hash & mask;
+
+			while ( _slots[i] != 0 )
+				i = ( i + 1 ) & mask;
+
+			_slots[i] = (uint32_t) ( id + 1 );
+		}
+	}
+
+	//---------------------------------------------------------------------------
+
+	template <typename CharT>
+	uint32_t BasicTokenDictionary<CharT>::intern ( View token )
+	{
+		if ( 2 * ( _entries.size() + 1 ) > _slots.size() )
+			_grow();
+
+		uint64_t hash = _hash ( token );
+		size_t   i    = _slot ( token , hash );
+
+		if ( _slots[i] != 0 )
+			return _slots[i] - 1;
+
+		_entries.push_back ( { _arena.length() , token.length() , hash } );
+		_arena.append ( token.data() , token.length() );
+
+		_slots[i] = (uint32_t) _entries.size();
+
+		return _slots[i] - 1;
+	}
+
+	//---------------------------------------------------------------------------
+
+	template <typename CharT>
+	uint32_t BasicTokenDictionary<CharT>::find ( View token ) const
+	{
+		if ( _entries.empty() )
+			return npos;
+
+		uint32_t slot = _slots[ _slot ( token , _hash ( token ) ) ];
+
+		return slot == 0 ? npos : slot - 1;
+	}
+
+	//---------------------------------------------------------------------------
+
+	template <typename CharT>
+	void BasicTokenDictionary<CharT>::clear ( void )
+	{
+		_arena.clear();
+		_entries.clear();
+		std::fill ( _slots.begin() , _slots.end() , 0 );
+	}
+
+	//---------------------------------------------------------------------------
+
+	template class BasicTokenDictionary<char>;
+	template class BasicTokenDictionary<char16_t>;
+	template class BasicTokenDictionary<char32_t>;
+}
@@ -0,0 +1,104 @@
+#ifndef TokenizerH
+#define TokenizerH
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace FuzzyWuzzy
+{
+	/* One token of str: str.substr ( offset , length ) */
+	struct TokenSpan
+	{
+		size_t offset;
+		size_t length;
+	};
+
+	//---------------------------------------------------------------------------
+
+	/* Finds the same tokens as the regular expression [\w\d]+ , i.e. the runs
+	*   of [A-Za-z0-9_] (bytes above 0x7f never belong to a token), and stores
+	*   them in spans, which is cleared first. The bytes are classified 64 at a
+	*   time with SSE2 or AVX2 when the CPU has it; reusing spans keeps the
+	*   tokenizer off the allocator.
+	*/
+	void find_tokens ( const char* str , size_t len , std::vector<TokenSpan>& spans );
+
+	inline void find_tokens ( std::string_view str , std::vector<TokenSpan>& spans )
+	{
+		find_tokens ( str.data() , str.length() , spans );
+	}
+
+	/* Same for UTF-16 code units and code points: the tokens are the runs of
+	*   characters for which unicode_is_word ( see Unicode.h ) holds
+	*/
+	void find_tokens ( const char16_t* str , size_t len , std::vector<TokenSpan>& spans );
+	void find_tokens ( const char32_t* str , size_t len , std::vector<TokenSpan>& spans );
+
+	/* bit i of the result is set when str[i] is a token character, len <= 64 */
+	uint64_t token_mask ( const char* str , size_t len );
+
+	//---------------------------------------------------------------------------
+
+	/* Interns tokens as consecutive ids 0, 1, ... in the order they are first
+	*   added. The characters are copied once into an arena, the ids are found
+	*   through an open addressing hash map that is at most half full, so set
+	*   operations on tokens can run on sorted vectors of ids. clear() keeps
+	*   the memory for the next use.
+	*/
+	template <typename CharT>
+	class BasicTokenDictionary
+	{
+	public:
+
+		typedef std::basic_string_view<CharT> View;
+
+		static const uint32_t npos = UINT32_MAX;
+
+	private :
+
+		struct Entry
+		{
+			size_t   offset;
+			size_t   length;
+			uint64_t hash;
+		};
+
+		std::basic_string<CharT> _arena;
+		std::vector<Entry>       _entries;
+		std::vector<uint32_t>    _slots;    /* id + 1, 0 marks a free slot */
+
+		static uint64_t _hash ( View token );
+
+		size_t _slot ( View token , uint64_t hash ) const;
+		void   _grow ( void );
+
+	public:
+
+		/* the id of token, which is added first when it is new */
+		uint32_t intern ( View token );
+
+		/* the id of token, npos when it was never added */
+		uint32_t find   ( View token ) const;
+
+		View token ( uint32_t id ) const
+		{
+			return View ( _arena.data() + _entries[id].offset , _entries[id].length );
+		}
+
+		size_t size  ( void ) const { return _entries.size(); }
+		void   clear ( void );
+	};
+
+	typedef BasicTokenDictionary<char>     TokenDictionary;
+	typedef BasicTokenDictionary<char16_t> U16TokenDictionary;
+	typedef BasicTokenDictionary<char32_t> U32TokenDictionary;
+
+	extern template class BasicTokenDictionary<char>;
+	extern template class BasicTokenDictionary<char16_t>;
+	extern template class BasicTokenDictionary<char32_t>;
+}
+
+#endif
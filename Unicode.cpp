@@ -0,0 +1,305 @@
+#include "Unicode.h"
+#include <algorithm>
+#include <string.h>
+
+namespace FuzzyWuzzy
+{
+	static const char32_t REPLACEMENT_CHARACTER = 0xFFFD;
+
+	//---------------------------------------------------------------------------
+
+	static inline bool _is_continuation ( unsigned char ch )
+	{
+		return ( ch & 0xC0 ) == 0x80;
+	}
+
+	//---------------------------------------------------------------------------
+
+	/* Decodes the sequence starting at str[0] into ch and returns its length,
+	*   0 when it is not valid
+	*/
+	static size_t _decode_sequence ( const unsigned char* str , size_t len , char32_t& ch )
+	{
+		unsigned char lead = str[0];
+
+		if ( lead >= 0xC2 && lead <= 0xDF )
+		{
+			if ( len < 2 || !_is_continuation ( str[1] ) )
+				return 0;
+
+			ch = ( (char32_t) ( lead & 0x1F ) << 6 ) | ( str[1] & 0x3F );
+			return 2;
+		}
+
+		if ( lead >= 0xE0 && lead <= 0xEF )
+		{
+			// no overlong forms below 0x800, no surrogates
+			unsigned char lo = lead == 0xE0 ? 0xA0 : 0x80;
+			unsigned char hi = lead == 0xED ? 0x9F : 0xBF;
+
+			if ( len < 3 || str[1] < lo || str[1] > hi || !_is_continuation ( str[2] ) )
+				return 0;
+
+			ch = ( (char32_t) ( lead & 0x0F ) << 12 ) | ( (char32_t) ( str[1] & 0x3F ) << 6 ) | ( str[2] & 0x3F );
+			return 3;
+		}
+
+		if ( lead >= 0xF0 && lead <= 0xF4 )
+		{
+			// no overlong forms below 0x10000, nothing above 0x10ffff
+			unsigned char lo = lead == 0xF0 ? 0x90 : 0x80;
+			unsigned char hi = lead == 0xF4 ? 0x8F : 0xBF;
+
+			if ( len < 4 || str[1] < lo || str[1] > hi || !_is_continuation ( str[2] ) || !_is_continuation ( str[3] ) )
+				return 0;
+
+			ch = ( (char32_t) ( lead & 0x07 ) << 18 ) | ( (char32_t) ( str[1] & 0x3F ) << 12 ) |
+				 ( (char32_t) ( str[2] & 0x3F ) << 6 ) | ( str[3] & 0x3F );
+			return 4;
+		}
+
+		return 0;
+	}
+
+	//---------------------------------------------------------------------------
+
+	void utf8_decode ( const char* str , size_t len , std::u32string& out )
+	{
+		const unsigned char* s = (const unsigned char*) str;
+		size_t               i = 0;
+		size_t               n = 0;
+
+		// never more code points than bytes
+		out.resize ( len );
+
+		char32_t* dst = &out[0];
+
+		while ( i < len )
+		{
+			uint64_t word;
+
+			if ( i + 8 <= len && ( memcpy ( &word , s + i , 8 ) , ( word & 0x8080808080808080ULL ) == 0 ) )
+			{
+				for ( size_t k = 0 ; k < 8 ; k++ )
+					dst[n++] = s[i + k];
+				i += 8;
+			}
+			else if ( s[i] < 0x80 )
+			{
+				dst[n++] = s[i++];
+			}
+			else
+			{
+				char32_t ch;
+				size_t   seq = _decode_sequence ( s + i , len - i , ch );
+
+				if ( seq == 0 )
+				{
+					dst[n++] = REPLACEMENT_CHARACTER;
+					i++;
+				}
+				else
+				{
+					dst[n++] = ch;
+					i += seq;
+				}
+			}
+		}
+
+		out.resize ( n );
+	}
+
+	std::u32string utf8_decode ( const std::string& str )
+	{
+		std::u32string out;
+
+		utf8_decode ( str.data() , str.length() , out );
+
+		return out;
+	}
+
+	//---------------------------------------------------------------------------
+
+	std::string utf8_encode ( const std::u32string& str )
+	{
+		std::string out;
+
+		out.reserve ( str.length() );
+
+		for ( std::u32string::const_iterator it = str.begin(); it != str.end(); ++it )
+		{
+			char32_t ch = *it;
+
+			if ( ch < 0x80 )
+				out += (char) ch;
+			else if ( ch < 0x800 )
+			{
+				out += (char) ( 0xC0 | ( ch >> 6 ) );
+				out += (char) ( 0x80 | ( ch & 0x3F ) );
+			}
+			else if ( ch < 0x10000 )
+			{
+				out += (char) ( 0xE0 | ( ch >> 12 ) );
+				out += (char) ( 0x80 | ( ( ch >> 6 ) & 0x3F ) );
+				out += (char) ( 0x80 | ( ch & 0x3F ) );
+			}
+			else
+			{
+				out += (char) ( 0xF0 | ( ch >> 18 ) );
+				out += (char) ( 0x80 | ( ( ch >> 12 ) & 0x3F ) );
+				out += (char) ( 0x80 | ( ( ch >> 6 ) & 0x3F ) );
+				out += (char) ( 0x80 | ( ch & 0x3F ) );
+			}
+		}
+
+		return out;
+	}
+
+	//---------------------------------------------------------------------------
+
+	/* Code points above ASCII that are not part of a token, sorted ranges */
+	static const uint32_t NON_WORD[][2] =
+	{
+		{ 0x00080 , 0x000A9 } ,  // C1 controls, no-break space, Latin-1 punctuation and signs
+		{ 0x000AB , 0x000B1 } ,
+		{ 0x000B4 , 0x000B4 } ,
+		{ 0x000B6 , 0x000B8 } ,
+		{ 0x000BB , 0x000BB } ,
+		{ 0x000BF , 0x000BF } ,
+		{ 0x000D7 , 0x000D7 } ,  // multiplication sign
+		{ 0x000F7 , 0x000F7 } ,  // division sign
+		{ 0x0037E , 0x0037E } ,  // Greek question mark
+		{ 0x00387 , 0x00387 } ,  // Greek ano teleia
+		{ 0x0055A , 0x0055F } ,  // Armenian punctuation
+		{ 0x00589 , 0x0058A } ,
+		{ 0x005BE , 0x005BE } ,  // Hebrew punctuation
+		{ 0x005C0 , 0x005C0 } ,
+		{ 0x005C3 , 0x005C3 } ,
+		{ 0x005C6 , 0x005C6 } ,
+		{ 0x005F3 , 0x005F4 } ,
+		{ 0x00600 , 0x0060F } ,  // Arabic signs and punctuation
+		{ 0x0061B , 0x0061F } ,
+		{ 0x0066A , 0x0066D } ,
+		{ 0x006D4 , 0x006D4 } ,
+		{ 0x00964 , 0x00965 } ,  // Devanagari danda
+		{ 0x00970 , 0x00970 } ,
+		{ 0x00E3F , 0x00E3F } ,  // Thai baht sign and punctuation
+		{ 0x00E4F , 0x00E4F } ,
+		{ 0x00E5A , 0x00E5B } ,
+		{ 0x010FB , 0x010FB } ,  // Georgian paragraph separator
+		{ 0x01680 , 0x01680 } ,  // Ogham space mark
+		{ 0x02000 , 0x0206F } ,  // general punctuation, spaces and format characters
+		{ 0x020A0 , 0x020CF } ,  // currency symbols
+		{ 0x02190 , 0x0245F } ,  // arrows, mathematical operators, technical symbols
+		{ 0x02500 , 0x02775 } ,  // box drawing, shapes, symbols, dingbats
+		{ 0x02794 , 0x02BFF } ,  // arrows and mathematical symbols
+		{ 0x02E00 , 0x02E7F } ,  // supplemental punctuation
+		{ 0x03000 , 0x03004 } ,  // CJK spaces, punctuation and brackets
+		{ 0x03008 , 0x03020 } ,
+		{ 0x03030 , 0x03030 } ,
+		{ 0x0303D , 0x0303F } ,
+		{ 0x030A0 , 0x030A0 } ,  // Katakana double hyphen
+		{ 0x030FB , 0x030FB } ,  // Katakana middle dot
+		{ 0x0FD3E , 0x0FD3F } ,  // ornate parentheses
+		{ 0x0FE10 , 0x0FE19 } ,  // vertical forms
+		{ 0x0FE30 , 0x0FE6F } ,  // CJK compatibility and small forms
+		{ 0x0FEFF , 0x0FEFF } ,  // byte order mark
+		{ 0x0FF01 , 0x0FF0F } ,  // fullwidth punctuation and signs
+		{ 0x0FF1A , 0x0FF20 } ,
+		{ 0x0FF3B , 0x0FF40 } ,
+		{ 0x0FF5B , 0x0FF65 } ,
+		{ 0x0FFE0 , 0x0FFEE } ,
+		{ 0x0FFF9 , 0x0FFFF } ,  // specials, the replacement character included
+		{ 0x1F000 , 0x1FAFF } ,  // tiles, cards, emoji and pictographs
+		{ 0xE0000 , 0xE007F }    // tags
+	};
+
+	bool unicode_is_word ( uint32_t ch )
+	{
+		if ( ch < 0x80 )
+			return ( ch >= '0' && ch <= '9' ) || ( ch >= 'A' && ch <= 'Z' ) ||
+				   ( ch >= 'a' && ch <= 'z' ) || ch == '_';
+
+		// the last range starting at or before ch
+		const size_t count = sizeof ( NON_WORD ) / sizeof ( NON_WORD[0] );
+		size_t       lo    = 0;
+		size_t       hi    = count;
+
+		while ( lo < hi )
+		{
+			size_t mid = ( lo + hi ) / 2;
+
+			if ( NON_WORD[mid][0] <= ch )
+				lo = mid + 1;
+			else
+				hi = mid;
+		}
+
+		return lo == 0 || ch > NON_WORD[lo - 1][1];
+	}
+
+	//---------------------------------------------------------------------------
+
+	uint32_t unicode_to_lower ( uint32_t ch )
+	{
+		if ( ch < 0x80 )
+			return ch >= 'A' && ch <= 'Z' ? ch + 0x20 : ch;
+
+		// Latin-1, Latin Extended-A
+		if ( ch < 0x100 )
+			return ch >= 0xC0 && ch <= 0xDE && ch != 0xD7 ? ch + 0x20 : ch;
+		if ( ch < 0x180 )
+		{
+			if ( ch == 0x130 ) return 'i';
+			if ( ch == 0x178 ) return 0xFF;
+			if ( ( ch < 0x138 && ch != 0x131 ) || ( ch >= 0x14A && ch < 0x178 ) )
+				return ch | 1;
+			if ( ( ch >= 0x139 && ch < 0x149 ) || ( ch >= 0x179 && ch < 0x17F ) )
+				return ch & 1 ? ch + 1 : ch;
+			return ch;
+		}
+
+		// Greek
+		if ( ch >= 0x386 && ch < 0x3AC )
+		{
+			if ( ch == 0x386 )               return 0x3AC;
+			if ( ch >= 0x388 && ch < 0x38B ) return ch + 0x25;
+			if ( ch == 0x38C )               return 0x3CC;
+			if ( ch == 0x38E || ch == 0x38F ) return ch + 0x3F;
+			if ( ch >= 0x391 && ch != 0x3A2 ) return ch + 0x20;
+			return ch;
+		}
+
+		// Cyrillic
+		if ( ch >= 0x400 && ch < 0x530 )
+		{
+			if ( ch < 0x410 )                return ch + 0x50;
+			if ( ch < 0x430 )                return ch + 0x20;
+			if ( ( ch >= 0x460 && ch < 0x482 ) || ( ch >= 0x48A && ch < 0x4C0 ) || ch >= 0x4D0 )
+				return ch | 1;
+			if ( ch == 0x4C0 )               return 0x4CF;
+			if ( ch >= 0x4C1 && ch < 0x4CF ) return ch & 1 ? ch + 1 : ch;
+			return ch;
+		}
+
+		// Armenian
+		if ( ch >= 0x531 && ch < 0x557 )
+			return ch + 0x30;
+
+		// Latin Extended Additional
+		if ( ch >= 0x1E00 && ch < 0x1F00 )
+		{
+			if ( ch == 0x1E9E )
+				return 0xDF;
+			if ( ch < 0x1E96 || ch >= 0x1EA0 )
+				return ch | 1;
+			return ch;
+		}
+
+		// fullwidth Latin
+		if ( ch >= 0xFF21 && ch <= 0xFF3A )
+			return ch + 0x20;
+
+		return ch;
+	}
+}
@@ -0,0 +1,37 @@
+#ifndef UnicodeH
+#define UnicodeH
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+
+namespace FuzzyWuzzy
+{
+	/* Decodes the UTF-8 str into out, which is cleared first. A byte that does
+	*   not start a valid sequence (overlong forms, surrogates and values above
+	*   0x10ffff are not valid) becomes U+FFFD on its own. Runs of ASCII are
+	*   copied 8 bytes at a time.
+	*/
+	void           utf8_decode ( const char* str , size_t len , std::u32string& out );
+	std::u32string utf8_decode ( const std::string& str );
+
+	/* Encodes code points as UTF-8, the inverse of utf8_decode for valid input */
+	std::string    utf8_encode ( const std::u32string& str );
+
+	//---------------------------------------------------------------------------
+
+	/* Whether ch belongs to a token: [A-Za-z0-9_] in ASCII, and above it
+	*   everything but the controls, spaces, punctuation and symbols of the
+	*   common blocks, i.e. the letters, digits and combining marks of every
+	*   script. Surrogates count as letters so that UTF-16 keeps the
+	*   characters outside the BMP in their token.
+	*/
+	bool     unicode_is_word  ( uint32_t ch );
+
+	/* Simple lower case mapping of the Latin, Greek, Cyrillic, Armenian and
+	*   fullwidth Latin letters, other code points are returned as they are
+	*/
+	uint32_t unicode_to_lower ( uint32_t ch );
+}
+
+#endif
@@ -0,0 +1,105 @@
+/**
+* BKTree::find against the distance of every term: built from a list, grown
+* by insert (from one of its own terms too), with duplicates, alone and on a
+* pool.
+*/
+//   g++ -std=c++17 -O2 -pthread -I.. ../*.cpp BKTreeTest.cpp -o BKTreeTest
+
+#include "Test.h"
+#include "BKTree.h"
+
+using namespace FuzzyWuzzy;
+
+/* the terms within k edits of query, by distance and then by id */
+static std::vector<BKTreeMatch> _reference_find ( const std::vector<std::string>& terms , const std::string& query , size_t k )
+{
+	std::vector<BKTreeMatch> matches;
+
+	for ( size_t i = 0 ; i < terms.size() ; i++ )
+	{
+		size_t distance = test::reference_distance ( query , terms[i] , 0 );
+
+		if ( distance <= k )
+			matches.push_back ( { i , distance } );
+	}
+
+	std::stable_sort ( matches.begin() , matches.end() ,
+					   [] ( const BKTreeMatch& a , const BKTreeMatch& b ) { return a.distance < b.distance; } );
+
+	return matches;
+}
+
+static bool _same ( const std::vector<BKTreeMatch>& a , const std::vector<BKTreeMatch>& b )
+{
+	if ( a.size() != b.size() )
+		return false;
+
+	for ( size_t i = 0 ; i < a.size() ; i++ )
+		if ( a[i].id != b[i].id || a[i].distance != b[i].distance )
+			return false;
+
+	return true;
+}
+
+int main ( void )
+{
+	test::Random rng ( 22 );
+	test::Check  check ( "BKTreeTest" );
+
+	const std::string alphabet = "abcdef";
+
+	ThreadPool pool ( 4 );
+
+	for ( int round = 0 ; round < 4 ; round++ )
+	{
+		std::vector<std::string> terms;
+
+		for ( size_t i = rng.below ( 3000 ) ; i > 0 ; i-- )
+			terms.push_back ( rng.string ( rng.below ( 12 ) , alphabet ) );
+
+		BKTree tree ( terms );
+		BKTree grown;
+
+		check ( tree.size() == terms.size() , "size" );
+
+		for ( const std::string& term : terms )
+			grown.insert ( term );
+
+		// terms of the tree itself, whose buffer grows while inserting them
+		for ( size_t i = 0 ; i < 500 && !terms.empty() ; i++ )
+		{
+			size_t id = rng.below ( terms.size() );
+
+			terms.push_back ( terms[id] );
+			check ( grown.insert ( grown.term ( id ) ) == terms.size() - 1 , "insert returns the id" );
+			check ( grown.term ( terms.size() - 1 ) == terms[id] , "insert of its own term" , terms[id] , "" );
+		}
+
+		for ( size_t id = 0 ; id < terms.size() ; id++ )
+			check ( grown.term ( id ) == terms[id] , "term" , terms[id] , "" );
+
+		std::vector<std::string> built_terms ( terms.begin() , terms.begin() + tree.size() );
+		std::vector<BKTreeMatch> found;
+
+		for ( int it = 0 ; it < 100 ; it++ )
+		{
+			std::string query = rng.below ( 2 ) && !terms.empty() ? rng.mutate ( terms[rng.below ( terms.size() )] , rng.below ( 4 ) , alphabet ) :
+																	rng.string ( rng.below ( 14 ) , alphabet );
+			size_t      k     = rng.below ( 5 );
+
+			std::vector<BKTreeMatch> expected       = _reference_find ( built_terms , query , k );
+			std::vector<BKTreeMatch> expected_grown = _reference_find ( terms , query , k );
+
+			tree.find ( query , k , found );
+			check ( _same ( found , expected ) , "find" , query , "" );
+			tree.find ( pool , query , k , found );
+			check ( _same ( found , expected ) , "find on a pool" , query , "" );
+			grown.find ( query , k , found );
+			check ( _same ( found , expected_grown ) , "find after insert" , query , "" );
+			grown.find ( pool , query , k , found );
+			check ( _same ( found , expected_grown ) , "find after insert on a pool" , query , "" );
+		}
+	}
+
+	return check.result();
+}
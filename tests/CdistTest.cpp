@@ -0,0 +1,83 @@
+/**
+* cdist against scoring every pair with the plain functions: the batched
+* ratio rows, the pretokenized choices, the mirrored upper triangle of
+* symmetric scorers and the rounding of integer matrices.
+*/
+//   g++ -std=c++17 -O2 -pthread -I.. ../*.cpp CdistTest.cpp -o CdistTest
+
+#include "Test.h"
+#include "Process.h"
+#include <cmath>
+
+using namespace FuzzyWuzzy;
+
+template <typename T , typename F>
+static bool _matches ( const process::Matrix<T>& m , const std::vector<std::string>& queries ,
+					   const std::vector<std::string>& choices , double cutoff , F f )
+{
+	if ( m.rows() != queries.size() || m.cols() != choices.size() )
+		return false;
+
+	for ( size_t i = 0 ; i < queries.size() ; i++ )
+	{
+		for ( size_t j = 0 ; j < choices.size() ; j++ )
+		{
+			double score = f ( queries[i] , choices[j] );
+
+			score = score >= cutoff ? score : 0;
+
+			if ( m ( i , j ) != ( std::is_integral<T>::value ? (T) std::lround ( score ) : (T) score ) )
+				return false;
+		}
+	}
+
+	return true;
+}
+
+template <typename CachedScorer , typename F>
+static void _check ( test::Check& check , const char* what , ThreadPool& pool ,
+					 const std::vector<std::string>& queries , const std::vector<std::string>& choices ,
+					 double cutoff , F f )
+{
+	process::Cached<CachedScorer> scorer;
+
+	check ( _matches<float>   ( process::cdist<float>   ( pool , queries , choices , scorer , cutoff ) , queries , choices , cutoff , f ) , what );
+	check ( _matches<uint8_t> ( process::cdist<uint8_t> ( pool , queries , choices , scorer , cutoff ) , queries , choices , cutoff , f ) , what );
+	check ( _matches<float>   ( process::cdist<float>   ( pool , choices , choices , scorer , cutoff ) , choices , choices , cutoff , f ) , what );
+}
+
+int main ( void )
+{
+	test::Random rng ( 7 );
+	test::Check  check ( "CdistTest" );
+
+	const std::string alphabet = "abcdef -";
+
+	ThreadPool pool ( 4 );
+
+	for ( int it = 0 ; it < 8 ; it++ )
+	{
+		std::vector<std::string> queries , choices;
+
+		for ( size_t i = rng.below ( 40 ) ; i > 0 ; i-- )
+			queries.push_back ( rng.string ( rng.below ( 30 ) , alphabet ) );
+		// more than one tile of columns, and strings past one machine word
+		for ( size_t i = rng.range ( 100 , 300 ) ; i > 0 ; i-- )
+			choices.push_back ( rng.string ( rng.below ( it % 3 == 0 ? 150 : 30 ) , alphabet ) );
+
+		double cutoff = it % 2 ? (double) rng.below ( 90 ) : 0;
+
+		_check<CachedRatio> ( check , "cdist ratio" , pool , queries , choices , cutoff ,
+							  [] ( const std::string& a , const std::string& b ) { return ratio ( a , b ); } );
+		_check<CachedPartialRatio> ( check , "cdist partial_ratio" , pool , queries , choices , cutoff ,
+									 [] ( const std::string& a , const std::string& b ) { return partial_ratio ( a , b ); } );
+		_check<CachedTokenSortRatio> ( check , "cdist token_sort_ratio" , pool , queries , choices , cutoff ,
+									   [] ( const std::string& a , const std::string& b ) { return token_sort_ratio ( a , b ); } );
+		_check<CachedTokenSetRatio> ( check , "cdist token_set_ratio" , pool , queries , choices , cutoff ,
+									  [] ( const std::string& a , const std::string& b ) { return token_set_ratio ( a , b ); } );
+		_check<CachedWRatio> ( check , "cdist WRatio" , pool , queries , choices , cutoff ,
+							   [] ( const std::string& a , const std::string& b ) { return WRatio ( a , b ); } );
+	}
+
+	return check.result();
+}
@@ -0,0 +1,67 @@
+/**
+* lev_edit_distance and the bit-parallel kernels against the full matrix,
+* across the 64 character block boundaries and with bytes above 0x7f.
+*/
+//   g++ -std=c++17 -O2 -pthread -I.. ../*.cpp LevenshteinTest.cpp -o LevenshteinTest
+
+#include "Test.h"
+#include "Levenshtein.h"
+
+using namespace FuzzyWuzzy;
+
+int main ( void )
+{
+	test::Random rng ( 1 );
+	test::Check  check ( "LevenshteinTest" );
+
+	const std::string alphabets[] = { "ab" , "abcdef" , "abcdefghijklmnopqrstuvwxyz" , "ab\xc3\xa9\xff" };
+
+	LevScratch scratch;
+
+	for ( int it = 0 ; it < 20000 ; it++ )
+	{
+		const std::string& alphabet = alphabets[rng.below ( 4 )];
+		size_t             max_len  = it % 10 == 0 ? 300 : 80;
+
+		std::string s1 = rng.string ( rng.below ( max_len ) , alphabet );
+		std::string s2 = it % 2 ? rng.mutate ( s1 , rng.below ( 20 ) , alphabet ) : rng.string ( rng.below ( max_len ) , alphabet );
+
+		for ( int xcost = 0 ; xcost < 2 ; xcost++ )
+		{
+			size_t expected = test::reference_distance ( s1 , s2 , xcost );
+
+			check ( lev_edit_distance ( s1.length() , s1.data() , s2.length() , s2.data() , xcost ) == expected ,
+					"lev_edit_distance" , s1 , s2 );
+			check ( lev_edit_distance ( s1.length() , s1.data() , s2.length() , s2.data() , xcost , scratch ) == expected ,
+					"lev_edit_distance with scratch" , s1 , s2 );
+			check ( lev_edit_distance_dp ( s1.length() , s1.data() , s2.length() , s2.data() , xcost ) == expected ,
+					"lev_edit_distance_dp" , s1 , s2 );
+
+			BlockPatternMatchVector block ( s1.length() , s1.data() );
+
+			check ( lev_bitpal_distance ( block , s2.length() , s2.data() , xcost ) == expected ,
+					"lev_bitpal_distance on blocks" , s1 , s2 );
+
+			if ( s1.length() <= 64 )
+			{
+				PatternMatchVector single ( s1.length() , s1.data() );
+
+				check ( lev_bitpal_distance ( single , s2.length() , s2.data() , xcost ) == expected ,
+						"lev_bitpal_distance on one word" , s1 , s2 );
+			}
+		}
+	}
+
+	// a few long pairs, many blocks each
+	for ( int it = 0 ; it < 20 ; it++ )
+	{
+		std::string s1 = rng.string ( rng.range ( 500 , 2000 ) , alphabets[1] );
+		std::string s2 = rng.mutate ( s1 , rng.below ( 400 ) , alphabets[1] );
+
+		for ( int xcost = 0 ; xcost < 2 ; xcost++ )
+			check ( lev_edit_distance ( s1.length() , s1.data() , s2.length() , s2.data() , xcost ) ==
+					test::reference_distance ( s1 , s2 , xcost ) , "lev_edit_distance on long strings" );
+	}
+
+	return check.result();
+}
@@ -0,0 +1,62 @@
+/**
+* lev_edit_distance_many against the distance of each pair alone: every lane
+* width, full and partly filled vectors, strings too long for a lane, and
+* texts longer than the lanes.
+*/
+//   g++ -std=c++17 -O2 -pthread -I.. ../*.cpp ManyTest.cpp -o ManyTest
+
+#include "Test.h"
+#include "Levenshtein.h"
+
+using namespace FuzzyWuzzy;
+
+int main ( void )
+{
+	test::Random rng ( 14 );
+	test::Check  check ( "ManyTest" );
+
+	const std::string alphabets[] = { "ab" , "abcdefgh" , std::string ( "\0\x01\x7f\x80\xfe\xff" "abc" , 9 ) };
+
+	LevScratch scratch;
+
+	for ( int it = 0 ; it < 2000 ; it++ )
+	{
+		const std::string& alphabet = alphabets[rng.below ( 3 )];
+
+		std::string              query = rng.string ( rng.below ( it % 4 == 0 ? 150 : 40 ) , alphabet );
+		std::vector<std::string> choices;
+
+		// up to several vectors of every width, and a few strings past 64
+		for ( size_t i = rng.below ( 300 ) ; i > 0 ; i-- )
+			choices.push_back ( rng.below ( 3 ) == 0 ? rng.mutate ( query , rng.below ( 10 ) , alphabet ) :
+													   rng.string ( rng.below ( rng.below ( 10 ) == 0 ? 100 : 65 ) , alphabet ) );
+
+		std::vector<const char*> strings;
+		std::vector<size_t>      lens;
+
+		for ( const std::string& choice : choices )
+		{
+			strings.push_back ( choice.data() );
+			lens.push_back ( choice.length() );
+		}
+
+		for ( int xcost = 0 ; xcost <= 1 ; xcost++ )
+		{
+			std::vector<size_t> dist ( choices.size() , (size_t) -1 );
+			std::vector<size_t> dist_scratch ( choices.size() , (size_t) -1 );
+
+			lev_edit_distance_many ( query.length() , query.data() , choices.size() , strings.data() , lens.data() , xcost , dist.data() );
+			lev_edit_distance_many ( query.length() , query.data() , choices.size() , strings.data() , lens.data() , xcost , dist_scratch.data() , scratch );
+
+			for ( size_t i = 0 ; i < choices.size() ; i++ )
+			{
+				size_t expected = test::reference_distance ( query , choices[i] , xcost );
+
+				check ( dist[i] == expected , xcost ? "lev_edit_distance_many Indel" : "lev_edit_distance_many Levenshtein" , query , choices[i] );
+				check ( dist_scratch[i] == expected , "lev_edit_distance_many with scratch" , query , choices[i] );
+			}
+		}
+	}
+
+	return check.result();
+}
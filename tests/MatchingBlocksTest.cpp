@@ -0,0 +1,202 @@
+/**
+* lev_editops_find against python-Levenshtein's editops on the full cost
+* matrix, operation for operation, from short pairs to pairs long and far
+* enough apart to recompute the diagonal band; and the matching blocks
+* taken from them.
+*/
+//   g++ -std=c++17 -O2 -pthread -I.. ../*.cpp MatchingBlocksTest.cpp -o MatchingBlocksTest
+
+#include "Test.h"
+#include "Levenshtein.h"
+#include "StringMatcher.h"
+
+using namespace FuzzyWuzzy;
+
+/* python-Levenshtein's editops: common prefix and suffix stripped, full
+*   matrix, then the walk back from the last cell preferring to keep going
+*   in the direction of the previous operation
+*/
+static std::vector<LevEditOp> _reference_editops ( const std::string& s1 , const std::string& s2 )
+{
+	size_t prefix = 0;
+
+	while ( prefix < s1.length() && prefix < s2.length() && s1[prefix] == s2[prefix] )
+		prefix++;
+
+	size_t len1 = s1.length() - prefix , len2 = s2.length() - prefix;
+
+	while ( len1 > 0 && len2 > 0 && s1[prefix + len1 - 1] == s2[prefix + len2 - 1] )
+	{
+		len1--;
+		len2--;
+	}
+
+	const char* a = s1.data() + prefix;
+	const char* b = s2.data() + prefix;
+	size_t      w = len2 + 1;
+
+	std::vector<size_t> matrix ( ( len1 + 1 ) * w );
+
+	for ( size_t j = 0 ; j <= len2 ; j++ )
+		matrix[j] = j;
+
+	for ( size_t i = 1 ; i <= len1 ; i++ )
+	{
+		matrix[i * w] = i;
+
+		for ( size_t j = 1 ; j <= len2 ; j++ )
+			matrix[i * w + j] = std::min ( std::min ( matrix[( i - 1 ) * w + j] , matrix[i * w + j - 1] ) + 1 ,
+										   matrix[( i - 1 ) * w + j - 1] + ( a[i - 1] != b[j - 1] ) );
+	}
+
+	std::vector<LevEditOp> ops ( matrix.back() );
+
+	size_t pos = ops.size() , i = len1 , j = len2;
+	int    dir = 0;
+
+	while ( i || j )
+	{
+		size_t here = matrix[i * w + j];
+
+		if ( dir < 0 && j && here == matrix[i * w + j - 1] + 1 )
+		{
+			j--;
+			ops[--pos] = { LEV_EDIT_INSERT , i + prefix , j + prefix };
+		}
+		else if ( dir > 0 && i && here == matrix[( i - 1 ) * w + j] + 1 )
+		{
+			i--;
+			ops[--pos] = { LEV_EDIT_DELETE , i + prefix , j + prefix };
+		}
+		else if ( i && j && here == matrix[( i - 1 ) * w + j - 1] && a[i - 1] == b[j - 1] )
+		{
+			i--;
+			j--;
+			dir = 0;
+		}
+		else if ( i && j && here == matrix[( i - 1 ) * w + j - 1] + 1 )
+		{
+			i--;
+			j--;
+			ops[--pos] = { LEV_EDIT_REPLACE , i + prefix , j + prefix };
+			dir = 0;
+		}
+		else if ( dir == 0 && j && here == matrix[i * w + j - 1] + 1 )
+		{
+			j--;
+			ops[--pos] = { LEV_EDIT_INSERT , i + prefix , j + prefix };
+			dir = -1;
+		}
+		else
+		{
+			i--;
+			ops[--pos] = { LEV_EDIT_DELETE , i + prefix , j + prefix };
+			dir = 1;
+		}
+	}
+
+	return ops;
+}
+
+/* the runs of characters between the operations, then ( len1 , len2 , 0 ) */
+static std::vector<LevMatchingBlock> _reference_blocks ( size_t len1 , size_t len2 , const std::vector<LevEditOp>& ops )
+{
+	std::vector<LevMatchingBlock> blocks;
+
+	size_t i = 0 , j = 0;
+
+	for ( const LevEditOp& op : ops )
+	{
+		if ( op.spos > i )
+		{
+			blocks.push_back ( { i , j , op.spos - i } );
+			j += op.spos - i;
+			i  = op.spos;
+		}
+
+		if ( op.type != LEV_EDIT_INSERT )
+			i++;
+		if ( op.type != LEV_EDIT_DELETE )
+			j++;
+	}
+
+	if ( i < len1 )
+		blocks.push_back ( { i , j , len1 - i } );
+
+	blocks.push_back ( { len1 , len2 , 0 } );
+
+	return blocks;
+}
+
+static bool _same_ops ( const std::vector<LevEditOp>& a , const std::vector<LevEditOp>& b )
+{
+	if ( a.size() != b.size() )
+		return false;
+
+	for ( size_t i = 0 ; i < a.size() ; i++ )
+		if ( a[i].type != b[i].type || a[i].spos != b[i].spos || a[i].dpos != b[i].dpos )
+			return false;
+
+	return true;
+}
+
+static bool _same_blocks ( const std::vector<LevMatchingBlock>& a , const std::vector<LevMatchingBlock>& b )
+{
+	if ( a.size() != b.size() )
+		return false;
+
+	for ( size_t i = 0 ; i < a.size() ; i++ )
+		if ( a[i].spos != b[i].spos || a[i].dpos != b[i].dpos || a[i].len != b[i].len )
+			return false;
+
+	return true;
+}
+
+int main ( void )
+{
+	test::Random rng ( 10 );
+	test::Check  check ( "MatchingBlocksTest" );
+
+	const std::string alphabets[] = { "ab" , "abcd" , "abcdefghijklmnopqrstuvwxyz" };
+
+	LevScratch                    scratch;
+	std::vector<LevEditOp>        ops;
+	std::vector<LevMatchingBlock> blocks;
+
+	for ( int it = 0 ; it < 5000 ; it++ )
+	{
+		const std::string& alphabet = alphabets[rng.below ( 3 )];
+
+		// mostly short, some long and close, some long and unrelated
+		size_t len = it % 50 == 0 ? rng.range ( 500 , 3000 ) : rng.below ( it % 5 == 0 ? 300 : 60 );
+
+		std::string s1 = rng.string ( len , alphabet );
+		std::string s2 = it % 3 == 0 ? rng.string ( it % 50 == 0 ? rng.below ( 3000 ) : rng.below ( 60 ) , alphabet ) :
+									   rng.mutate ( s1 , rng.below ( it % 50 == 0 ? 2000 : 20 ) , alphabet );
+
+		std::vector<LevEditOp> expected = _reference_editops ( s1 , s2 );
+
+		lev_editops_find ( s1.length() , s1.data() , s2.length() , s2.data() , ops , scratch );
+		check ( _same_ops ( ops , expected ) , "lev_editops_find" , s1 , s2 );
+
+		lev_matching_blocks ( s1.length() , s1.data() , s2.length() , s2.data() , blocks , scratch );
+
+		std::vector<LevMatchingBlock> expected_blocks = _reference_blocks ( s1.length() , s2.length() , expected );
+
+		check ( _same_blocks ( blocks , expected_blocks ) , "lev_matching_blocks" , s1 , s2 );
+
+		// SequenceMatcher returns the same blocks
+		SequenceMatcher       matcher ( s1 , s2 );
+		std::vector<Triple>*  triples = matcher.get_matching_blocks();
+		bool                  same    = triples->size() == expected_blocks.size();
+
+		for ( size_t i = 0 ; same && i < triples->size() ; i++ )
+			same = (size_t) (*triples)[i][0] == expected_blocks[i].spos &&
+				   (size_t) (*triples)[i][1] == expected_blocks[i].dpos &&
+				   (size_t) (*triples)[i][2] == expected_blocks[i].len;
+
+		check ( same , "SequenceMatcher::get_matching_blocks" , s1 , s2 );
+	}
+
+	return check.result();
+}
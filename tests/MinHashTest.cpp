@@ -0,0 +1,194 @@
+/**
+* MinHash signatures are those of token sets: the same for the same set, the
+* minimum of the parts for a union, on every signature size the vector lanes
+* split. MinHashLSH pairs exactly the strings with an equal band, its shards
+* together pair what one table does, and verify_pairs keeps the pairs
+* reaching the cutoff.
+*/
+//   g++ -std=c++17 -O2 -pthread -I.. ../*.cpp MinHashTest.cpp -o MinHashTest
+
+#include "Test.h"
+#include "MinHash.h"
+#include "FuzzyWuzzy.h"
+#include <cmath>
+#include <set>
+
+using namespace FuzzyWuzzy;
+
+typedef std::pair<uint32_t,uint32_t> IdPair;
+
+/* a few words, repeated and in any order */
+static std::string _text ( test::Random& rng , size_t words )
+{
+	static const char* vocabulary[] = { "acme" , "inc" , "corp" , "global" , "tech" , "data" , "the" , "of" ,
+										"group" , "bank" , "trust" , "a" , "x1" , "intl" , "co" , "ltd" };
+
+	std::string s;
+
+	for ( size_t i = rng.below ( words + 1 ) ; i > 0 ; i-- )
+		s += std::string ( vocabulary[rng.below ( 16 )] ) + ( rng.below ( 3 ) ? " " : ", " );
+
+	return s;
+}
+
+int main ( void )
+{
+	test::Random rng ( 25 );
+	test::Check  check ( "MinHashTest" );
+
+	ThreadPool pool ( 4 );
+
+	for ( size_t size : { 1 , 3 , 4 , 7 , 8 , 9 , 16 , 33 , 100 } )
+	{
+		MinHash               minhash ( size , size );
+		std::vector<uint32_t> sig1 ( size ) , sig2 ( size ) , sig_union ( size );
+
+		minhash.signature ( std::string ( " ,!" ) , sig1.data() );
+		check ( std::count ( sig1.begin() , sig1.end() , UINT32_MAX ) == (long) size , "signature without tokens" );
+
+		for ( int it = 0 ; it < 200 ; it++ )
+		{
+			std::string a = _text ( rng , 6 ) , b = _text ( rng , 6 );
+
+			minhash.signature ( a , sig1.data() );
+			minhash.signature ( b , sig2.data() );
+			minhash.signature ( a + " " + b , sig_union.data() );
+
+			bool is_min = true;
+
+			for ( size_t i = 0 ; i < size ; i++ )
+				is_min &= sig_union[i] == std::min ( sig1[i] , sig2[i] );
+
+			check ( is_min , "signature of a union" , a , b );
+
+			// the same token set in another order, repeated
+			minhash.signature ( b + " " + a + " " + a , sig2.data() );
+			check ( sig2 == sig_union , "signature of the same token set" , a , b );
+		}
+
+		std::vector<std::string> docs;
+
+		for ( size_t i = 0 ; i < 500 ; i++ )
+			docs.push_back ( _text ( rng , 5 ) );
+
+		std::vector<uint32_t> sigs;
+		bool                  rows_ok = true;
+
+		minhash.signatures ( pool , docs , sigs );
+
+		for ( size_t i = 0 ; i < docs.size() ; i++ )
+		{
+			minhash.signature ( docs[i] , sig1.data() );
+			rows_ok &= std::equal ( sig1.begin() , sig1.end() , sigs.begin() + i * size );
+		}
+
+		check ( sigs.size() == docs.size() * size && rows_ok , "signatures on a pool" );
+	}
+
+	// documents with many near duplicates
+	std::vector<std::string> docs;
+
+	for ( size_t i = 0 ; i < 600 ; i++ )
+		docs.push_back ( i >= 100 && rng.below ( 2 ) ? docs[rng.below ( 100 )] + " " + _text ( rng , 1 ) : _text ( rng , 4 ) );
+
+	for ( size_t bands : { 1 , 4 , 16 } )
+	{
+		for ( size_t rows : { 1 , 2 , 4 } )
+		{
+			MinHashLSH            lsh ( bands , rows );
+			std::vector<uint32_t> sigs;
+
+			lsh.hasher().signatures ( pool , docs , sigs );
+			for ( size_t i = 0 ; i < docs.size() ; i++ )
+				lsh.add ( (uint32_t) i , docs[i] );
+			lsh.build();
+
+			// the pairs agreeing on all the rows of a band
+			std::vector<IdPair> expected;
+
+			for ( uint32_t i = 0 ; i < docs.size() ; i++ )
+			{
+				for ( uint32_t j = i + 1 ; j < docs.size() ; j++ )
+				{
+					bool banded = false;
+
+					for ( size_t band = 0 ; !banded && band < bands ; band++ )
+						banded = std::equal ( sigs.begin() + i * bands * rows + band * rows , sigs.begin() + i * bands * rows + ( band + 1 ) * rows ,
+											  sigs.begin() + j * bands * rows + band * rows );
+
+					if ( banded )
+						expected.push_back ( { i , j } );
+				}
+			}
+
+			std::vector<IdPair> pairs;
+
+			lsh.candidate_pairs ( pairs );
+			check ( pairs == expected , "candidate_pairs" );
+
+			std::vector<uint32_t> ids;
+			bool                  candidates_ok = true;
+
+			for ( uint32_t i = 0 ; i < docs.size() ; i += 37 )
+			{
+				lsh.candidates ( sigs.data() + i * bands * rows , ids );
+
+				std::vector<uint32_t> want;
+
+				for ( uint32_t j = 0 ; j < docs.size() ; j++ )
+					if ( j == i || std::binary_search ( expected.begin() , expected.end() , IdPair ( std::min ( i , j ) , std::max ( i , j ) ) ) )
+						want.push_back ( j );
+
+				candidates_ok &= ids == want;
+			}
+
+			check ( candidates_ok , "candidates" );
+
+			// the shards of the data set pair the same ids
+			std::set<IdPair> sharded;
+
+			for ( size_t shard = 0 ; shard < 3 ; shard++ )
+			{
+				MinHashLSH part ( bands , rows , shard , 3 );
+
+				for ( size_t i = 0 ; i < docs.size() ; i++ )
+					part.add ( (uint32_t) i , sigs.data() + i * bands * rows );
+				part.build();
+				part.candidate_pairs ( pairs );
+				sharded.insert ( pairs.begin() , pairs.end() );
+			}
+
+			check ( std::vector<IdPair> ( sharded.begin() , sharded.end() ) == expected , "candidate_pairs of the shards" );
+
+			double probability = MinHashLSH::collision_probability ( 0.5 , bands , rows );
+
+			check ( std::abs ( probability - ( 1 - std::pow ( 1 - std::pow ( 0.5 , (double) rows ) , (double) bands ) ) ) < 1e-12 , "collision_probability" );
+
+			// the pairs reaching the cutoff, in order
+			double                  cutoff = (double) rng.below ( 101 );
+			std::vector<ScoredPair> verified , verified_pool;
+			std::vector<ScoredPair> want;
+
+			for ( const IdPair& pair : expected )
+			{
+				double score = token_set_ratio ( docs[pair.first] , docs[pair.second] );
+
+				if ( score >= cutoff )
+					want.push_back ( { pair.first , pair.second , score } );
+			}
+
+			verify_pairs ( docs , expected , cutoff , verified );
+			verify_pairs ( pool , docs , expected , cutoff , verified_pool );
+
+			bool same = verified.size() == want.size() && verified_pool.size() == want.size();
+
+			for ( size_t i = 0 ; same && i < want.size() ; i++ )
+				same = verified[i].first == want[i].first && verified[i].second == want[i].second && verified[i].score == want[i].score &&
+					   verified_pool[i].first == want[i].first && verified_pool[i].second == want[i].second && verified_pool[i].score == want[i].score;
+
+			check ( same , "verify_pairs" );
+		}
+	}
+
+	return check.result();
+}
@@ -0,0 +1,136 @@
+/**
+* ThreadPool::parallel_for runs every index once, also when several threads
+* share the pool, and the pool overloads of
+* extractBests, extract and extractOne return exactly what the serial ones
+* do, whatever the number of threads and the kind of range.
+*/
+//   g++ -std=c++17 -O2 -pthread -I.. ../*.cpp ParallelExtractTest.cpp -o ParallelExtractTest
+
+#include "Test.h"
+#include "Process.h"
+#include <list>
+#include <stdexcept>
+#include <thread>
+
+using namespace FuzzyWuzzy;
+
+template <typename Result>
+static bool _same ( const std::vector<Result>& a , const std::vector<Result>& b )
+{
+	if ( a.size() != b.size() )
+		return false;
+
+	for ( size_t i = 0 ; i < a.size() ; i++ )
+		if ( a[i].score != b[i].score || a[i].choice != b[i].choice || a[i].key != b[i].key )
+			return false;
+
+	return true;
+}
+
+int main ( void )
+{
+	test::Random rng ( 6 );
+	test::Check  check ( "ParallelExtractTest" );
+
+	const std::string alphabet = "abcdefgh -";
+
+	for ( size_t threads : { 1 , 2 , 4 , 8 } )
+	{
+		ThreadPool pool ( threads );
+
+		// every index once, on a valid worker
+		for ( size_t count : { 0 , 1 , 7 , 1000 , 100000 } )
+		{
+			std::vector< std::atomic<int> > runs ( count );
+			std::atomic<bool>               workers_ok ( true );
+
+			pool.parallel_for ( count , [&] ( size_t index , size_t worker )
+			{
+				runs[index]++;
+				if ( worker >= pool.size() )
+					workers_ok = false;
+			});
+
+			bool once = true;
+
+			for ( size_t i = 0 ; i < count ; i++ )
+				once &= runs[i] == 1;
+
+			check ( once , "parallel_for runs every index once" );
+			check ( workers_ok , "parallel_for worker in range" );
+		}
+
+		bool thrown = false;
+
+		try
+		{
+			pool.parallel_for ( 100 , [] ( size_t index , size_t ) { if ( index == 42 ) throw std::runtime_error ( "42" ); } );
+		}
+		catch ( const std::runtime_error& )
+		{
+			thrown = true;
+		}
+
+		check ( thrown , "parallel_for rethrows" );
+
+		// callers sharing the pool each run their own task on their own indices
+		const size_t callers = 4 , loops = 50 , count = 2000;
+
+		std::vector< std::vector< std::atomic<int> > > caller_runs ( callers );
+		std::vector<std::thread>                       outside;
+
+		for ( size_t c = 0 ; c < callers ; c++ )
+			caller_runs[c] = std::vector< std::atomic<int> > ( count );
+
+		for ( size_t c = 0 ; c < callers ; c++ )
+			outside.emplace_back ( [& , c] ( void )
+			{
+				for ( size_t loop = 0 ; loop < loops ; loop++ )
+					pool.parallel_for ( count , [&caller_runs , c] ( size_t index , size_t ) { caller_runs[c][index]++; } );
+			});
+
+		for ( std::thread& thread : outside )
+			thread.join();
+
+		bool shared_ok = true;
+
+		for ( size_t c = 0 ; c < callers ; c++ )
+			for ( size_t i = 0 ; i < count ; i++ )
+				shared_ok &= caller_runs[c][i] == (int) loops;
+
+		check ( shared_ok , "parallel_for from several threads" );
+
+		for ( int it = 0 ; it < 40 ; it++ )
+		{
+			std::vector<std::string> choices;
+			std::string              query = rng.string ( rng.range ( 1 , 15 ) , alphabet );
+
+			for ( size_t i = rng.below ( 5000 ) ; i > 0 ; i-- )
+				choices.push_back ( rng.below ( 8 ) == 0 ? rng.mutate ( query , rng.below ( 5 ) , alphabet ) :
+															rng.string ( rng.below ( 20 ) , alphabet ) );
+
+			std::list<std::string> listed ( choices.begin() , choices.end() );
+
+			double cutoff = (double) rng.below ( 80 );
+			size_t limit  = rng.below ( 10 );
+
+			check ( _same ( process::extractBests ( pool , query , choices , process::Cached<CachedWRatio>() , full_process , cutoff , limit ) ,
+							process::extractBests (        query , choices , process::Cached<CachedWRatio>() , full_process , cutoff , limit ) ) ,
+					"extractBests on a pool" );
+			check ( _same ( process::extractBests ( pool , query , listed , process::Cached<CachedRatio>() , process::no_process , cutoff , limit ) ,
+							process::extractBests (        query , listed , process::Cached<CachedRatio>() , process::no_process , cutoff , limit ) ) ,
+					"extractBests on a pool over a list" );
+			check ( _same ( process::extract ( pool , query , choices , process::Cached<CachedTokenSetRatio>() , full_process , limit ) ,
+							process::extract (        query , choices , process::Cached<CachedTokenSetRatio>() , full_process , limit ) ) ,
+					"extract on a pool" );
+
+			auto parallel = process::extractOne ( pool , query , choices , process::Cached<CachedPartialRatio>() , process::no_process , cutoff );
+			auto serial   = process::extractOne (        query , choices , process::Cached<CachedPartialRatio>() , process::no_process , cutoff );
+
+			check ( parallel.has_value() == serial.has_value() &&
+					( !serial || ( parallel->key == serial->key && parallel->score == serial->score ) ) , "extractOne on a pool" );
+		}
+	}
+
+	return check.result();
+}
@@ -0,0 +1,120 @@
+/**
+* partial_ratio against scoring every window of the longer string, full or
+* cut by either end, and past one machine word against python fuzzywuzzy's
+* windows lined up with the matching blocks: the score, the alignment that
+* gives it, and the score_cutoff and cached variants.
+*/
+//   g++ -std=c++17 -O2 -pthread -I.. ../*.cpp PartialRatioTest.cpp -o PartialRatioTest
+
+#include "Test.h"
+#include "FuzzyWuzzy.h"
+#include "StringMatcher.h"
+
+using namespace FuzzyWuzzy;
+
+/* best ratio of shorter with the windows of longer, above 99.5 counting as 100 */
+static double _reference_partial ( const std::string& shorter , const std::string& longer )
+{
+	double best = 0;
+	size_t n    = shorter.length();
+
+	auto window = [&] ( size_t start , size_t len )
+	{
+		double r = test::reference_ratio ( shorter , longer.substr ( start , len ) );
+
+		best = std::max ( best , r > 99.5 ? 100.0 : r );
+	};
+
+	for ( size_t len = 1 ; len < n ; len++ )
+		window ( 0 , len );
+	for ( size_t start = 0 ; start + n <= longer.length() ; start++ )
+		window ( start , n );
+	for ( size_t start = longer.length() - n + 1 ; start < longer.length() ; start++ )
+		window ( start , longer.length() - start );
+
+	return best;
+}
+
+/* best ratio of shorter with the windows of longer starting where a matching
+*   block puts the start of shorter, as python's fuzzywuzzy
+*/
+static double _reference_blocks_partial ( const std::string& shorter , const std::string& longer )
+{
+	double best = 0;
+
+	SequenceMatcher      matcher ( shorter , longer );
+	std::vector<Triple>* blocks = matcher.get_matching_blocks();
+
+	for ( Triple& block : *blocks )
+	{
+		size_t start = block[1] > block[0] ? block[1] - block[0] : 0;
+		double r     = test::reference_ratio ( shorter , longer.substr ( start , shorter.length() ) );
+
+		best = std::max ( best , r > 99.5 ? 100.0 : r );
+	}
+
+	return best;
+}
+
+/* the reference of partial_ratio ( s1 , s2 ), s1 counting as the shorter one on equal lengths */
+static double _expected ( const std::string& s1 , const std::string& s2 )
+{
+	const std::string& shorter = s1.length() <= s2.length() ? s1 : s2;
+	const std::string& longer  = s1.length() <= s2.length() ? s2 : s1;
+
+	return shorter.length() <= 64 ? _reference_partial ( shorter , longer ) : _reference_blocks_partial ( shorter , longer );
+}
+
+int main ( void )
+{
+	test::Random rng ( 11 );
+	test::Check  check ( "PartialRatioTest" );
+
+	for ( int it = 0 ; it < 10000 ; it++ )
+	{
+		std::string alphabet = std::string ( "abcdefghij" ).substr ( 0 , rng.range ( 2 , 10 ) );
+
+		// patterns past one machine word now and then
+		size_t n = rng.range ( 1 , it % 4 == 0 ? 150 : 40 );
+
+		std::string shorter = rng.string ( n , alphabet );
+		std::string longer  = it % 2 ? rng.string ( n + rng.below ( 80 ) , alphabet ) :
+									   rng.string ( rng.below ( 40 ) , alphabet ) + rng.mutate ( shorter , rng.below ( 5 ) , alphabet ) +
+									   rng.string ( rng.below ( 40 ) , alphabet );
+
+		if ( longer.length() < shorter.length() )
+			std::swap ( shorter , longer );
+
+		if ( shorter.empty() )
+			continue;
+
+		bool               swapped = rng.below ( 2 );
+		const std::string& s1      = swapped ? longer : shorter;
+		const std::string& s2      = swapped ? shorter : longer;
+
+		double expected = _expected ( s1 , s2 );
+
+		ScoreAlignment alignment = partial_ratio_alignment ( s1 , s2 );
+
+		check ( alignment.score == expected , "partial_ratio_alignment score" , s1 , s2 );
+		check ( partial_ratio ( s1 , s2 ) == expected , "partial_ratio" , s1 , s2 );
+
+		// the alignment gives the score
+		double aligned = ratio ( s1.substr ( alignment.src_start , alignment.src_end - alignment.src_start ) ,
+								 s2.substr ( alignment.dest_start , alignment.dest_end - alignment.dest_start ) );
+
+		check ( expected == 0 || ( aligned > 99.5 ? 100.0 : aligned ) == expected , "partial_ratio_alignment windows" , s1 , s2 );
+
+		double cutoffs[] = { (double) rng.below ( 101 ) , expected };
+
+		for ( double cutoff : cutoffs )
+		{
+			double want = expected >= cutoff ? expected : 0;
+
+			check ( partial_ratio ( s1 , s2 , cutoff ) == want , "partial_ratio with score_cutoff" , s1 , s2 );
+			check ( CachedPartialRatio ( s1 ).similarity ( s2 , cutoff ) == want , "CachedPartialRatio" , s1 , s2 );
+		}
+	}
+
+	return check.result();
+}
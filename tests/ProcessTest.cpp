@@ -0,0 +1,124 @@
+/**
+* extractWithoutOrder, extractBests, extract and extractOne against sorting
+* every score: best first, the earlier choice on ties, none below the
+* cutoff. Cached and plain scorers, processors and keyed ranges.
+*/
+//   g++ -std=c++17 -O2 -pthread -I.. ../*.cpp ProcessTest.cpp -o ProcessTest
+
+#include "Test.h"
+#include "Process.h"
+#include <map>
+
+using namespace FuzzyWuzzy;
+
+struct Expected
+{
+	size_t index;
+	double score;
+};
+
+/* the limit best of scores reaching cutoff (limit 0 keeps all) */
+static std::vector<Expected> _best ( const std::vector<double>& scores , double cutoff , size_t limit )
+{
+	std::vector<Expected> best;
+
+	for ( size_t i = 0 ; i < scores.size() ; i++ )
+		if ( scores[i] >= cutoff )
+			best.push_back ( { i , scores[i] } );
+
+	std::stable_sort ( best.begin() , best.end() , [] ( const Expected& a , const Expected& b ) { return a.score > b.score; } );
+
+	if ( limit != 0 && best.size() > limit )
+		best.resize ( limit );
+
+	return best;
+}
+
+template <typename Result>
+static bool _same ( const std::vector<Result>& results , const std::vector<Expected>& expected ,
+					const std::vector<std::string>& choices )
+{
+	if ( results.size() != expected.size() )
+		return false;
+
+	for ( size_t i = 0 ; i < results.size() ; i++ )
+		if ( results[i].score != expected[i].score || results[i].choice != choices[expected[i].index] )
+			return false;
+
+	return true;
+}
+
+int main ( void )
+{
+	test::Random rng ( 5 );
+	test::Check  check ( "ProcessTest" );
+
+	const std::string alphabet = "abcdeABC -,";
+
+	for ( int it = 0 ; it < 300 ; it++ )
+	{
+		std::vector<std::string> choices;
+		std::string              query = rng.string ( rng.range ( 1 , 20 ) , alphabet );
+
+		for ( size_t i = rng.below ( 200 ) ; i > 0 ; i-- )
+			choices.push_back ( rng.below ( 4 ) == 0 ? rng.mutate ( query , rng.below ( 6 ) , alphabet ) :
+														rng.string ( rng.below ( 25 ) , alphabet ) );
+
+		double cutoff = (double) rng.below ( 90 );
+		size_t limit  = rng.below ( 8 );
+
+		// WRatio on processed strings, the defaults
+		std::vector<double> wratio;
+		std::string         processed = full_process ( query );
+
+		for ( const std::string& choice : choices )
+			wratio.push_back ( WRatio ( processed , full_process ( choice ) ) );
+
+		check ( _same ( process::extractBests ( query , choices , process::Cached<CachedWRatio>() , full_process , cutoff , limit ) ,
+						_best ( wratio , cutoff , limit ) , choices ) , "extractBests" );
+		check ( _same ( process::extract ( query , choices , process::Cached<CachedWRatio>() , full_process , limit ) ,
+						_best ( wratio , 0 , limit ) , choices ) , "extract" );
+
+		std::vector<Expected> one = _best ( wratio , cutoff , 1 );
+		auto                  found = process::extractOne ( query , choices , process::Cached<CachedWRatio>() , full_process , cutoff );
+
+		check ( one.empty() ? !found : found && found->key == one[0].index && found->score == one[0].score , "extractOne" );
+
+		// a plain callable without processing, in the order of the choices
+		std::vector<double> ratios;
+
+		for ( const std::string& choice : choices )
+			ratios.push_back ( ratio ( query , choice ) );
+
+		auto scorer    = [] ( const std::string& a , const std::string& b ) { return ratio ( a , b ); };
+		auto unordered = process::extractWithoutOrder ( query , choices , scorer , process::no_process , cutoff );
+
+		std::vector<Expected> kept;
+
+		for ( size_t i = 0 ; i < ratios.size() ; i++ )
+			if ( ratios[i] >= cutoff )
+				kept.push_back ( { i , ratios[i] } );
+
+		check ( _same ( unordered , kept , choices ) , "extractWithoutOrder" );
+		check ( _same ( process::extractBests ( query , choices , process::Cached<CachedRatio>() , process::no_process , cutoff , limit ) ,
+						_best ( ratios , cutoff , limit ) , choices ) , "extractBests with CachedRatio" );
+
+		// keyed choices keep their keys
+		std::map<int,std::string> keyed;
+
+		for ( size_t i = 0 ; i < choices.size() ; i++ )
+			keyed[(int) i * 3] = choices[i];
+
+		auto results = process::extractBests ( query , keyed , process::Cached<CachedRatio>() , process::no_process , cutoff , limit );
+		auto best    = _best ( ratios , cutoff , limit );
+
+		bool keys_ok = results.size() == best.size();
+
+		for ( size_t i = 0 ; keys_ok && i < results.size() ; i++ )
+			keys_ok = results[i].key == (int) best[i].index * 3 && results[i].score == best[i].score;
+
+		check ( keys_ok , "extractBests over a map" );
+	}
+
+	return check.result();
+}
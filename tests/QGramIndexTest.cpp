@@ -0,0 +1,97 @@
+/**
+* QGramIndex never drops a choice whose ratio or partial_ratio reaches the
+* cutoff, for every q, and extracting through it returns what scoring every
+* choice does.
+*/
+//   g++ -std=c++17 -O2 -pthread -I.. ../*.cpp QGramIndexTest.cpp -o QGramIndexTest
+
+#include "Test.h"
+#include "Process.h"
+
+using namespace FuzzyWuzzy;
+
+template <typename Result>
+static bool _same ( const std::vector<Result>& a , const std::vector<Result>& b )
+{
+	if ( a.size() != b.size() )
+		return false;
+
+	for ( size_t i = 0 ; i < a.size() ; i++ )
+		if ( a[i].key != b[i].key || a[i].score != b[i].score )
+			return false;
+
+	return true;
+}
+
+int main ( void )
+{
+	test::Random rng ( 21 );
+	test::Check  check ( "QGramIndexTest" );
+
+	const std::string alphabet = "aabbc de";
+
+	std::vector<std::string> choices;
+
+	for ( size_t i = 0 ; i < 3000 ; i++ )
+		choices.push_back ( rng.string ( rng.below ( 40 ) , alphabet ) );
+	// shorter than any q-gram
+	choices.push_back ( "" );
+	choices.push_back ( "a" );
+	choices.push_back ( "ab" );
+
+	for ( size_t q = 1 ; q <= 4 ; q++ )
+	{
+		QGramIndex index ( choices , q );
+
+		for ( int it = 0 ; it < 100 ; it++ )
+		{
+			std::string query;
+
+			switch ( it % 3 )
+			{
+				case 0 :  query = rng.mutate ( choices[rng.below ( choices.size() )] , rng.below ( 4 ) , alphabet ); break;
+				case 1 :  query = rng.string ( rng.below ( 12 ) , alphabet ); break;
+				default : query = choices[rng.below ( choices.size() )]; break;
+			}
+
+			double cutoff = it % 4 == 0 ? 100 : (double) rng.below ( 101 );
+
+			for ( int partial = 0 ; partial <= 1 ; partial++ )
+			{
+				std::vector<uint32_t> ids;
+				std::vector<bool>     candidate ( choices.size() , false );
+
+				index.candidates ( query , cutoff , partial , ids );
+
+				bool sorted = std::is_sorted ( ids.begin() , ids.end() ) && std::adjacent_find ( ids.begin() , ids.end() ) == ids.end();
+
+				check ( sorted , "candidates in increasing order" , query , "" );
+
+				for ( uint32_t id : ids )
+					candidate[id] = true;
+
+				for ( size_t i = 0 ; i < choices.size() ; i++ )
+				{
+					double score = partial ? partial_ratio ( query , choices[i] ) : ratio ( query , choices[i] );
+
+					if ( score >= cutoff )
+						check ( candidate[i] , partial ? "candidates for partial_ratio" : "candidates for ratio" , query , choices[i] );
+				}
+			}
+
+			size_t limit = rng.below ( 8 );
+
+			check ( _same ( process::extractBests ( index , query , process::Cached<CachedRatio>() , cutoff , limit ) ,
+							process::extractBests ( query , choices , process::Cached<CachedRatio>() , process::no_process , cutoff , limit ) ) ,
+					"extractBests over the index" , query , "" );
+
+			auto indexed = process::extractOne ( index , query , process::Cached<CachedPartialRatio>() , cutoff );
+			auto plain   = process::extractOne ( query , choices , process::Cached<CachedPartialRatio>() , process::no_process , cutoff );
+
+			check ( indexed.has_value() == plain.has_value() && ( !plain || ( indexed->key == plain->key && indexed->score == plain->score ) ) ,
+					"extractOne over the index" , query , "" );
+		}
+	}
+
+	return check.result();
+}
@@ -0,0 +1,88 @@
+/**
+* SequenceMatcher's quick_ratio against counting the characters both strings
+* share, real_quick_ratio against the lengths, the two bounding ratio from
+* above, and ratio ( score_cutoff ) rejecting exactly the pairs below it.
+*/
+//   g++ -std=c++17 -O2 -pthread -I.. ../*.cpp QuickRatioTest.cpp -o QuickRatioTest
+
+#include "Test.h"
+#include "StringMatcher.h"
+#include <cmath>
+#include <map>
+
+using namespace FuzzyWuzzy;
+
+/* difflib's quick_ratio on a multiset of characters */
+template <typename CharT>
+static double _reference_quick ( const std::basic_string<CharT>& s1 , const std::basic_string<CharT>& s2 )
+{
+	size_t lensum = s1.length() + s2.length();
+
+	if ( lensum == 0 )
+		return 1.0;
+
+	std::map<CharT,size_t> available;
+	size_t                 matches = 0;
+
+	for ( CharT ch : s1 )
+		available[ch]++;
+	for ( CharT ch : s2 )
+		if ( available[ch] > 0 )
+		{
+			available[ch]--;
+			matches++;
+		}
+
+	return (double)(2 * matches)/(double)lensum;
+}
+
+template <typename CharT>
+static void _check ( test::Check& check , test::Random& rng , const std::basic_string<CharT>& alphabet , const char* what )
+{
+	for ( int it = 0 ; it < 3000 ; it++ )
+	{
+		// both sides of the 64 characters the histogram waits for
+		size_t len = rng.below ( it % 3 == 0 ? 200 : 40 );
+
+		std::basic_string<CharT> s1 = rng.string ( len , alphabet );
+		std::basic_string<CharT> s2 = it % 2 ? rng.string ( rng.below ( 200 ) , alphabet ) :
+											   rng.mutate ( s1 , rng.below ( len + 1 ) , alphabet );
+
+		size_t shorter = std::min ( s1.length() , s2.length() );
+		size_t lensum  = s1.length() + s2.length();
+
+		BasicSequenceMatcher<CharT> matcher ( s1 , s2 );
+
+		double quick      = matcher.quick_ratio();
+		double real_quick = matcher.real_quick_ratio();
+		double ratio      = matcher.ratio();
+
+		check ( quick == _reference_quick ( s1 , s2 ) , what );
+		check ( real_quick == ( lensum ? (double)(2 * shorter)/(double)lensum : 1.0 ) , what );
+		check ( real_quick >= quick && quick >= ratio , what );
+		check ( std::abs ( ratio * 100.0 - test::reference_ratio ( s1 , s2 ) ) < 1e-9 , what );
+
+		// a fresh matcher each time, ratio() caches
+		double cutoffs[] = { rng.below ( 101 ) / 100.0 , ratio , real_quick , quick };
+
+		for ( double cutoff : cutoffs )
+		{
+			double want = ratio >= cutoff ? ratio : 0;
+
+			check ( BasicSequenceMatcher<CharT> ( s1 , s2 ).ratio ( cutoff ) == want , what );
+			check ( BasicSequenceMatcherView<CharT> ( s1 , s2 ).ratio ( cutoff ) == want , what );
+		}
+	}
+}
+
+int main ( void )
+{
+	test::Random rng ( 13 );
+	test::Check  check ( "QuickRatioTest" );
+
+	_check<char>     ( check , rng , std::string    ( "abcdefgh \xe9\xff" ) , "SequenceMatcher bounds" );
+	_check<char16_t> ( check , rng , std::u16string ( u"abcdé中二" ) , "U16SequenceMatcher bounds" );
+	_check<char32_t> ( check , rng , std::u32string ( U"abcd\U0001F600中" ) , "U32SequenceMatcher bounds" );
+
+	return check.result();
+}
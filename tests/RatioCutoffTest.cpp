@@ -0,0 +1,56 @@
+/**
+* The score_cutoff overloads of ratio and the bounded distances: a bounded
+* call gives the same result as the unbounded one whenever that reaches the
+* bound, including a cutoff equal to the score.
+*/
+//   g++ -std=c++17 -O2 -pthread -I.. ../*.cpp RatioCutoffTest.cpp -o RatioCutoffTest
+
+#include "Test.h"
+#include "FuzzyWuzzy.h"
+#include "Levenshtein.h"
+
+using namespace FuzzyWuzzy;
+
+int main ( void )
+{
+	test::Random rng ( 2 );
+	test::Check  check ( "RatioCutoffTest" );
+
+	const std::string alphabets[] = { "ab" , "abcdef" , "abcdefghijklmnopqrstuvwxyz -" };
+
+	for ( int it = 0 ; it < 20000 ; it++ )
+	{
+		const std::string& alphabet = alphabets[rng.below ( 3 )];
+		size_t             max_len  = it % 10 == 0 ? 200 : 40;
+
+		std::string s1 = rng.string ( rng.below ( max_len ) , alphabet );
+		std::string s2 = it % 2 ? rng.mutate ( s1 , rng.below ( 10 ) , alphabet ) : rng.string ( rng.below ( max_len ) , alphabet );
+
+		for ( int xcost = 0 ; xcost < 2 ; xcost++ )
+		{
+			size_t d   = test::reference_distance ( s1 , s2 , xcost );
+			size_t max = rng.below ( d + 3 );
+			size_t cut = d <= max ? d : max + 1;
+
+			check ( lev_edit_distance ( s1.length() , s1.data() , s2.length() , s2.data() , xcost , max ) == cut ,
+					"lev_edit_distance with max" , s1 , s2 );
+			check ( lev_edit_distance_banded ( s1.length() , s1.data() , s2.length() , s2.data() , xcost , max ) == cut ,
+					"lev_edit_distance_banded" , s1 , s2 );
+		}
+
+		double score = ratio ( s1 , s2 );
+
+		check ( score == test::reference_ratio ( s1 , s2 ) , "ratio" , s1 , s2 );
+
+		double cutoffs[] = { (double) rng.below ( 101 ) , score , score + 1e-9 , 0 , 100 };
+
+		for ( double cutoff : cutoffs )
+			check ( ratio ( s1 , s2 , cutoff ) == ( score >= cutoff ? score : 0 ) , "ratio with score_cutoff" , s1 , s2 );
+
+		CachedRatio cached ( s1 );
+
+		check ( cached.similarity ( s2 , score ) == score , "CachedRatio at its own score" , s1 , s2 );
+	}
+
+	return check.result();
+}
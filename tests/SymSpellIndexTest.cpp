@@ -0,0 +1,91 @@
+/**
+* SymSpellIndex::find against the distance of every term, for each maximum
+* distance and prefix length, built alone and on a pool, with k above the
+* maximum lowered to it.
+*/
+//   g++ -std=c++17 -O2 -pthread -I.. ../*.cpp SymSpellIndexTest.cpp -o SymSpellIndexTest
+
+#include "Test.h"
+#include "SymSpellIndex.h"
+
+using namespace FuzzyWuzzy;
+
+/* the terms within k edits of query, by distance and then by id */
+static std::vector<SymSpellMatch> _reference_find ( const std::vector<std::string>& terms , const std::string& query , size_t k )
+{
+	std::vector<SymSpellMatch> matches;
+
+	for ( size_t i = 0 ; i < terms.size() ; i++ )
+	{
+		size_t distance = test::reference_distance ( query , terms[i] , 0 );
+
+		if ( distance <= k )
+			matches.push_back ( { i , distance } );
+	}
+
+	std::stable_sort ( matches.begin() , matches.end() ,
+					   [] ( const SymSpellMatch& a , const SymSpellMatch& b ) { return a.distance < b.distance; } );
+
+	return matches;
+}
+
+static bool _same ( const std::vector<SymSpellMatch>& a , const std::vector<SymSpellMatch>& b )
+{
+	if ( a.size() != b.size() )
+		return false;
+
+	for ( size_t i = 0 ; i < a.size() ; i++ )
+		if ( a[i].id != b[i].id || a[i].distance != b[i].distance )
+			return false;
+
+	return true;
+}
+
+int main ( void )
+{
+	test::Random rng ( 23 );
+	test::Check  check ( "SymSpellIndexTest" );
+
+	const std::string alphabet = "abcdef";
+
+	ThreadPool pool ( 4 );
+
+	std::vector<std::string> terms;
+
+	// duplicates, the empty term and terms past every prefix length
+	for ( size_t i = 0 ; i < 2000 ; i++ )
+		terms.push_back ( rng.string ( rng.below ( 14 ) , alphabet ) );
+	terms.push_back ( "" );
+	terms.push_back ( terms[0] );
+
+	for ( size_t max_distance = 0 ; max_distance <= 3 ; max_distance++ )
+	{
+		for ( size_t prefix_length : { 0 , 1 , 4 , 7 } )
+		{
+			SymSpellIndex index ( terms , max_distance , prefix_length );
+			SymSpellIndex pooled ( pool , terms , max_distance , prefix_length );
+
+			check ( index.size() == terms.size() && index.max_distance() == max_distance , "size and max_distance" );
+			check ( index.variant_count() == pooled.variant_count() && index.posting_count() == pooled.posting_count() ,
+					"the same index on a pool" );
+
+			std::vector<SymSpellMatch> found;
+
+			for ( int it = 0 ; it < 40 ; it++ )
+			{
+				std::string query = rng.below ( 2 ) ? rng.mutate ( terms[rng.below ( terms.size() )] , rng.below ( 4 ) , alphabet ) :
+													  rng.string ( rng.below ( 16 ) , alphabet );
+				size_t      k     = rng.below ( max_distance + 3 );
+
+				std::vector<SymSpellMatch> expected = _reference_find ( terms , query , std::min ( k , max_distance ) );
+
+				index.find ( query , k , found );
+				check ( _same ( found , expected ) , "find" , query , "" );
+				pooled.find ( query , k , found );
+				check ( _same ( found , expected ) , "find built on a pool" , query , "" );
+			}
+		}
+	}
+
+	return check.result();
+}
@@ -0,0 +1,167 @@
+/**
+* Equivalence tests: each program checks a fast path of the library against
+* a plain reference on random strings and exits with 0 when they all agree.
+* Build and run one from this directory, e.g.
+*/
+//   g++ -std=c++17 -O2 -pthread -I.. ../*.cpp LevenshteinTest.cpp -o LevenshteinTest && ./LevenshteinTest
+
+#ifndef TestH
+#define TestH
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace FuzzyWuzzy
+{
+namespace test
+{
+	/* Deterministic random strings */
+	class Random
+	{
+	private :
+
+		std::mt19937 _rng;
+
+	public:
+
+		explicit Random ( uint32_t seed ) : _rng ( seed ) {}
+
+		// uniform in [0, n)
+		size_t below ( size_t n ) { return n == 0 ? 0 : _rng() % n; }
+
+		// uniform in [lo, hi]
+		size_t range ( size_t lo , size_t hi ) { return lo + below ( hi - lo + 1 ); }
+
+		// len characters drawn from alphabet
+		template <typename CharT>
+		std::basic_string<CharT> string ( size_t len , const std::basic_string<CharT>& alphabet )
+		{
+			std::basic_string<CharT> s;
+
+			for ( size_t i = 0 ; i < len ; i++ )
+				s += alphabet[below ( alphabet.length() )];
+
+			return s;
+		}
+
+		// s after edits random deletions, insertions and substitutions from alphabet
+		template <typename CharT>
+		std::basic_string<CharT> mutate ( std::basic_string<CharT> s , size_t edits , const std::basic_string<CharT>& alphabet )
+		{
+			for ( size_t i = 0 ; i < edits ; i++ )
+			{
+				size_t pos = below ( s.length() + 1 );
+
+				switch ( below ( 3 ) )
+				{
+					case 0 :
+						if ( pos < s.length() )
+							s.erase ( pos , 1 );
+						break;
+					case 1 :
+						s.insert ( pos , 1 , alphabet[below ( alphabet.length() )] );
+						break;
+					default :
+						if ( pos < s.length() )
+							s[pos] = alphabet[below ( alphabet.length() )];
+						break;
+				}
+			}
+
+			return s;
+		}
+	};
+
+	//---------------------------------------------------------------------------
+
+	/* Failures of the running test: the first few are printed */
+	class Check
+	{
+	private :
+
+		const char* _name;
+		size_t      _checks , _failures;
+
+	public:
+
+		explicit Check ( const char* name ) : _name ( name ) , _checks ( 0 ) , _failures ( 0 ) {}
+
+		bool operator() ( bool ok , const char* what )
+		{
+			_checks++;
+
+			if ( !ok && _failures++ < 10 )
+				fprintf ( stderr , "%s: %s failed\n" , _name , what );
+
+			return ok;
+		}
+
+		bool operator() ( bool ok , const char* what , const std::string& s1 , const std::string& s2 )
+		{
+			if ( !(*this) ( ok , what ) && _failures <= 10 )
+				fprintf ( stderr , "    '%s'\n    '%s'\n" , s1.c_str() , s2.c_str() );
+
+			return ok;
+		}
+
+		// the exit code of the test
+		int result ( void ) const
+		{
+			printf ( "%s: %zu checks, %zu failed\n" , _name , _checks , _failures );
+
+			return _failures == 0 ? 0 : 1;
+		}
+	};
+
+	//---------------------------------------------------------------------------
+
+	/* Full matrix Levenshtein distance, substitutions costing 2 when xcost
+	*   is set (Indel distance)
+	*/
+	template <typename CharT>
+	size_t reference_distance ( const std::basic_string<CharT>& s1 , const std::basic_string<CharT>& s2 , int xcost )
+	{
+		std::vector<size_t> row ( s2.length() + 1 );
+
+		for ( size_t j = 0 ; j <= s2.length() ; j++ )
+			row[j] = j;
+
+		for ( size_t i = 1 ; i <= s1.length() ; i++ )
+		{
+			size_t diagonal = row[0];
+
+			row[0] = i;
+
+			for ( size_t j = 1 ; j <= s2.length() ; j++ )
+			{
+				size_t above = row[j];
+				size_t cost  = s1[i - 1] == s2[j - 1] ? 0 : ( xcost ? 2 : 1 );
+
+				row[j]   = std::min ( std::min ( above , row[j - 1] ) + 1 , diagonal + cost );
+				diagonal = above;
+			}
+		}
+
+		return row[s2.length()];
+	}
+
+	/* ratio from the Indel distance, on the 0..100 scale */
+	template <typename CharT>
+	double reference_ratio ( const std::basic_string<CharT>& s1 , const std::basic_string<CharT>& s2 )
+	{
+		size_t lensum = s1.length() + s2.length();
+
+		if ( lensum == 0 )
+			return 100.0;
+
+		return 100.0 * ( (double)(lensum - reference_distance ( s1 , s2 , 1 )) / (double)lensum );
+	}
+}
+}
+
+#endif
@@ -0,0 +1,119 @@
+/**
+* TokenIndex never drops a choice whose token_set_ratio reaches the cutoff,
+* misspelled tokens and choices without tokens included, extracting through
+* it returns what scoring every choice does, and the token ranks follow the
+* document frequencies.
+*/
+//   g++ -std=c++17 -O2 -pthread -I.. ../*.cpp TokenIndexTest.cpp -o TokenIndexTest
+
+#include "Test.h"
+#include "Process.h"
+#include <map>
+#include <set>
+
+using namespace FuzzyWuzzy;
+
+/* a few words from a vocabulary, some of them with typos */
+static std::string _text ( test::Random& rng )
+{
+	static const char* words[] = { "acme" , "inc" , "corp" , "ltd" , "global" , "tech" , "data" , "systems" , "the" , "of" ,
+								   "group" , "holdings" , "a" , "ab" , "x" , "intl" , "services" , "co" , "bank" , "trust" };
+
+	std::string s;
+
+	for ( size_t i = rng.below ( 6 ) ; i > 0 ; i-- )
+	{
+		std::string word = words[rng.below ( 20 )];
+
+		if ( rng.below ( 5 ) == 0 )
+			word = rng.mutate ( word , rng.range ( 1 , 2 ) , std::string ( "aeiost" ) );
+		s += ( s.empty() ? "" : rng.below ( 3 ) ? " " : ", " ) + word;
+	}
+	if ( rng.below ( 10 ) == 0 )
+		s += "!!";
+
+	return s;
+}
+
+static std::set<std::string> _token_set ( const std::string& s )
+{
+	std::vector<TokenSpan> spans;
+	std::set<std::string>  tokens;
+
+	find_tokens ( s.data() , s.length() , spans );
+
+	for ( const TokenSpan& span : spans )
+		tokens.insert ( s.substr ( span.offset , span.length ) );
+
+	return tokens;
+}
+
+int main ( void )
+{
+	test::Random rng ( 24 );
+	test::Check  check ( "TokenIndexTest" );
+
+	std::vector<std::string> choices;
+
+	for ( size_t i = 0 ; i < 3000 ; i++ )
+		choices.push_back ( _text ( rng ) );
+
+	TokenIndex index ( choices );
+
+	// document frequencies, rarest first
+	std::map<std::string,uint32_t> frequencies;
+
+	for ( const std::string& choice : choices )
+		for ( const std::string& token : _token_set ( choice ) )
+			frequencies[token]++;
+
+	check ( index.token_count() == frequencies.size() , "token_count" );
+
+	for ( const auto& entry : frequencies )
+	{
+		uint32_t rank = index.rank ( entry.first );
+
+		check ( rank < index.token_count() && index.frequency ( rank ) == entry.second , "rank and frequency" , entry.first , "" );
+		check ( rank == 0 || index.frequency ( rank - 1 ) <= entry.second , "ranks rarest first" , entry.first , "" );
+	}
+	check ( index.rank ( "zzz" ) == (uint32_t) std::string::npos , "rank of a missing token" );
+
+	for ( int it = 0 ; it < 300 ; it++ )
+	{
+		std::string query = it % 4 ? choices[rng.below ( choices.size() )] : _text ( rng ) + " zzz";
+		double      cutoff = (double) rng.below ( 101 );
+
+		std::vector<uint32_t> ids;
+		std::vector<bool>     candidate ( choices.size() , false );
+
+		index.candidates ( query , cutoff , ids );
+
+		bool sorted = std::is_sorted ( ids.begin() , ids.end() ) && std::adjacent_find ( ids.begin() , ids.end() ) == ids.end();
+
+		check ( sorted , "candidates in increasing order" , query , "" );
+
+		for ( uint32_t id : ids )
+			candidate[id] = true;
+
+		for ( size_t i = 0 ; i < choices.size() ; i++ )
+			if ( token_set_ratio ( query , choices[i] ) >= cutoff )
+				check ( candidate[i] , "candidates" , query , choices[i] );
+
+		auto indexed = process::extractBests ( index , query , process::Cached<CachedTokenSetRatio>() , cutoff , 0 );
+		auto plain   = process::extractBests ( query , choices , process::Cached<CachedTokenSetRatio>() , process::no_process , cutoff , 0 );
+
+		bool same = indexed.size() == plain.size();
+
+		for ( size_t i = 0 ; same && i < plain.size() ; i++ )
+			same = indexed[i].key == plain[i].key && indexed[i].score == plain[i].score;
+
+		check ( same , "extractBests over the index" , query , "" );
+
+		auto one = process::extractOne ( index , query , process::Cached<CachedTokenSetRatio>() , cutoff );
+
+		check ( one.has_value() == !plain.empty() && ( plain.empty() || ( one->key == plain[0].key && one->score == plain[0].score ) ) ,
+				"extractOne over the index" , query , "" );
+	}
+
+	return check.result();
+}
@@ -0,0 +1,158 @@
+/**
+* token_sort_ratio, token_set_ratio and their partial forms against the
+* original string building: split, sort, join, trim and concatenate, then
+* score the strings. Cached scorers, pretokenized choices and score_cutoff.
+*/
+//   g++ -std=c++17 -O2 -pthread -I.. ../*.cpp TokenScorersTest.cpp -o TokenScorersTest
+
+#include "Test.h"
+#include "FuzzyWuzzy.h"
+#include <cmath>
+#include <set>
+
+using namespace FuzzyWuzzy;
+
+/* the runs of letters, digits and underscores */
+static std::vector<std::string> _tokens ( const std::string& s )
+{
+	std::vector<std::string> tokens;
+	std::string              token;
+
+	for ( char ch : s )
+	{
+		if ( isalnum ( (unsigned char) ch ) || ch == '_' )
+			token += ch;
+		else if ( !token.empty() )
+		{
+			tokens.push_back ( token );
+			token.clear();
+		}
+	}
+	if ( !token.empty() )
+		tokens.push_back ( token );
+
+	return tokens;
+}
+
+static std::string _join ( const std::vector<std::string>& tokens )
+{
+	std::string joined;
+
+	for ( const std::string& token : tokens )
+		joined += ( joined.empty() ? "" : " " ) + token;
+
+	return joined;
+}
+
+static std::string _trim ( const std::string& s )
+{
+	size_t begin = s.find_first_not_of ( ' ' );
+
+	return begin == std::string::npos ? "" : s.substr ( begin , s.find_last_not_of ( ' ' ) - begin + 1 );
+}
+
+static double _score ( const std::string& a , const std::string& b , bool partial )
+{
+	return partial ? partial_ratio ( a , b ) : test::reference_ratio ( a , b );
+}
+
+static double _reference_sort ( const std::string& s1 , const std::string& s2 , bool partial )
+{
+	std::vector<std::string> tokens1 = _tokens ( s1 ) , tokens2 = _tokens ( s2 );
+
+	std::sort ( tokens1.begin() , tokens1.end() );
+	std::sort ( tokens2.begin() , tokens2.end() );
+
+	return _score ( _join ( tokens1 ) , _join ( tokens2 ) , partial );
+}
+
+/* partial_token_set_ratio scores the same: the original never read its
+*   partial flag
+*/
+static double _reference_set ( const std::string& s1 , const std::string& s2 )
+{
+	std::vector<std::string> tokens1 = _tokens ( s1 ) , tokens2 = _tokens ( s2 );
+	std::set<std::string>    set1 ( tokens1.begin() , tokens1.end() ) , set2 ( tokens2.begin() , tokens2.end() );
+	std::vector<std::string> sect , diff1to2 , diff2to1;
+
+	std::set_intersection ( set1.begin() , set1.end() , set2.begin() , set2.end() , std::back_inserter ( sect ) );
+	std::set_difference   ( set1.begin() , set1.end() , set2.begin() , set2.end() , std::back_inserter ( diff1to2 ) );
+	std::set_difference   ( set2.begin() , set2.end() , set1.begin() , set1.end() , std::back_inserter ( diff2to1 ) );
+
+	std::string sorted_sect   = _join ( sect );
+	std::string combined_1to2 = _trim ( sorted_sect + " " + _join ( diff1to2 ) );
+	std::string combined_2to1 = _trim ( sorted_sect + " " + _join ( diff2to1 ) );
+
+	return std::max ( std::max ( test::reference_ratio ( sorted_sect , combined_1to2 ) ,
+								 test::reference_ratio ( sorted_sect , combined_2to1 ) ) ,
+					  test::reference_ratio ( combined_1to2 , combined_2to1 ) );
+}
+
+/* words from a small vocabulary, repeated and shuffled, between separators */
+static std::string _text ( test::Random& rng )
+{
+	static const char* words[] = { "new" , "york" , "mets" , "yankees" , "st" , "street" , "a" , "b" , "_x" , "42" ,
+								   "Acme" , "acme" , "inc" , "co" , "foo" , "fooo" , "bar" , "baz" };
+	static const char* separators[] = { " " , "  " , ", " , "-" , "\t" , " & " };
+
+	std::string s = rng.below ( 5 ) == 0 ? " " : "";
+
+	for ( size_t i = rng.below ( rng.below ( 8 ) == 0 ? 40 : 7 ) ; i > 0 ; i-- )
+	{
+		s += words[rng.below ( 18 )];
+		if ( i > 1 || rng.below ( 4 ) == 0 )
+			s += separators[rng.below ( 6 )];
+	}
+
+	return s;
+}
+
+int main ( void )
+{
+	test::Random rng ( 17 );
+	test::Check  check ( "TokenScorersTest" );
+
+	for ( int it = 0 ; it < 10000 ; it++ )
+	{
+		std::string s1 = _text ( rng );
+		std::string s2 = it % 4 == 0 ? s1 + " " + _text ( rng ) : _text ( rng );
+
+		if ( rng.below ( 2 ) )
+			std::swap ( s1 , s2 );
+
+		double sort         = _reference_sort ( s1 , s2 , false );
+		double partial_sort = _reference_sort ( s1 , s2 , true );
+		double set          = _reference_set  ( s1 , s2 );
+
+		check ( std::abs ( token_sort_ratio ( s1 , s2 ) - sort ) < 1e-9 , "token_sort_ratio" , s1 , s2 );
+		check ( partial_token_sort_ratio ( s1 , s2 ) == partial_sort , "partial_token_sort_ratio" , s1 , s2 );
+		check ( std::abs ( token_set_ratio ( s1 , s2 ) - set ) < 1e-9 , "token_set_ratio" , s1 , s2 );
+		check ( std::abs ( partial_token_set_ratio ( s1 , s2 ) - set ) < 1e-9 , "partial_token_set_ratio" , s1 , s2 );
+
+		// the cached scorers, on strings and on pretokenized choices
+		TokenizedString tokenized ( s2 );
+
+		double cutoffs[] = { 0 , (double) rng.below ( 101 ) };
+
+		for ( double cutoff : cutoffs )
+		{
+			double scores[] = { token_sort_ratio ( s1 , s2 ) , partial_token_sort_ratio ( s1 , s2 ) ,
+								token_set_ratio ( s1 , s2 ) , partial_token_set_ratio ( s1 , s2 ) };
+			double want[4];
+
+			for ( size_t k = 0 ; k < 4 ; k++ )
+				want[k] = scores[k] >= cutoff ? scores[k] : 0;
+
+			check ( CachedTokenSortRatio ( s1 ).similarity ( s2 , cutoff ) == want[0] , "CachedTokenSortRatio" , s1 , s2 );
+			check ( CachedTokenSortRatio ( s1 ).similarity ( tokenized , cutoff ) == want[0] , "CachedTokenSortRatio pretokenized" , s1 , s2 );
+			check ( CachedPartialTokenSortRatio ( s1 ).similarity ( s2 , cutoff ) == want[1] , "CachedPartialTokenSortRatio" , s1 , s2 );
+			check ( CachedPartialTokenSortRatio ( s1 ).similarity ( tokenized , cutoff ) == want[1] , "CachedPartialTokenSortRatio pretokenized" , s1 , s2 );
+			check ( CachedTokenSetRatio ( s1 ).similarity ( s2 , cutoff ) == want[2] , "CachedTokenSetRatio" , s1 , s2 );
+			check ( CachedTokenSetRatio ( s1 ).similarity ( tokenized , cutoff ) == want[2] , "CachedTokenSetRatio pretokenized" , s1 , s2 );
+			check ( CachedPartialTokenSetRatio ( s1 ).similarity ( s2 , cutoff ) == want[3] , "CachedPartialTokenSetRatio" , s1 , s2 );
+			check ( CachedPartialTokenSetRatio ( s1 ).similarity ( tokenized , cutoff ) == want[3] , "CachedPartialTokenSetRatio pretokenized" , s1 , s2 );
+		}
+	}
+
+	return check.result();
+}
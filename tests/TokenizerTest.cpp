@@ -0,0 +1,123 @@
+/**
+* find_tokens and token_mask against the regular expression they replace,
+* [\w\d]+ through Pattern and Matcher::findAll: every byte value, bytes above
+* 0x7f included, on lengths around the 16, 32 and 64 byte blocks of the
+* vector classifier. The widest kernel the CPU has is the one checked.
+*/
+//   g++ -std=c++17 -O2 -pthread -I.. -I../RegularExpressions ../*.cpp ../RegularExpressions/Pattern.cpp ../RegularExpressions/Matcher.cpp TokenizerTest.cpp -o TokenizerTest
+
+#include "Test.h"
+#include "Tokenizer.h"
+#include "RegularExpressions/regexp/Matcher.h"
+#include "RegularExpressions/regexp/Pattern.h"
+
+using namespace FuzzyWuzzy;
+
+/* runs of token bytes between runs of any other bytes */
+static std::string _text ( test::Random& rng , size_t len , const std::string& word , const std::string& other )
+{
+	std::string s;
+
+	while ( s.length() < len )
+	{
+		const std::string& alphabet = rng.below ( 2 ) ? word : other;
+
+		s += rng.string ( std::min ( rng.range ( 1 , 20 ) , len - s.length() ) , alphabet );
+	}
+
+	return s;
+}
+
+static std::vector<std::string> _find_all ( Pattern* p , const std::string& s )
+{
+	Matcher*                 m      = p->createMatcher ( s );
+	std::vector<std::string> tokens = m->findAll();
+
+	delete m;
+
+	return tokens;
+}
+
+int main ( void )
+{
+	test::Random rng ( 8 );
+	test::Check  check ( "TokenizerTest" );
+
+	Pattern* p = Pattern::compile ( "[\\w\\d]+" );
+
+	// the bytes the regular expression takes for token characters
+	std::string word , other;
+	bool        is_word[256];
+
+	for ( int ch = 1 ; ch < 256 ; ch++ )
+	{
+		is_word[ch] = p->matches ( std::string ( 1 , (char) ch ) );
+		( is_word[ch] ? word : other ) += (char) ch;
+	}
+	is_word[0] = false;
+
+	check ( word.length() == 63 , "63 token characters" );
+
+	std::vector<TokenSpan> spans;
+
+	for ( size_t blocks = 0 ; blocks <= 3 ; blocks++ )
+	{
+		for ( size_t tail : { 0 , 1 , 2 , 15 , 16 , 17 , 31 , 32 , 33 , 47 , 48 , 63 } )
+		{
+			size_t len = 64 * blocks + tail;
+
+			for ( int it = 0 ; it < 300 ; it++ )
+			{
+				std::string s = _text ( rng , len , word , other );
+
+				std::vector<std::string> expected = _find_all ( p , s );
+
+				find_tokens ( s , spans );
+
+				bool same = spans.size() == expected.size();
+
+				for ( size_t i = 0 ; same && i < spans.size() ; i++ )
+					same = s.compare ( spans[i].offset , spans[i].length , expected[i] ) == 0;
+
+				check ( same , "find_tokens" , s , "" );
+
+				// every 64 byte block and the tail
+				bool mask_ok = true;
+
+				for ( size_t base = 0 ; base < len ; base += 64 )
+				{
+					size_t   block = std::min ( (size_t) 64 , len - base );
+					uint64_t mask  = token_mask ( s.data() + base , block );
+
+					for ( size_t i = 0 ; i < block ; i++ )
+						mask_ok &= ( ( mask >> i ) & 1 ) == is_word[(unsigned char) s[base + i]];
+					mask_ok &= block == 64 || ( mask >> block ) == 0;
+				}
+
+				check ( mask_ok , "token_mask" , s , "" );
+			}
+		}
+	}
+
+	// each byte value alone and in every position of a block
+	bool all_bytes = true;
+
+	for ( int ch = 0 ; ch < 256 ; ch++ )
+	{
+		for ( size_t pos = 0 ; pos < 64 ; pos++ )
+		{
+			std::string s ( 64 , ' ' );
+
+			s[pos] = (char) ch;
+			find_tokens ( s , spans );
+			all_bytes &= token_mask ( s.data() , 64 ) == ( is_word[ch] ? (uint64_t) 1 << pos : 0 ) &&
+						 spans.size() == ( is_word[ch] ? 1u : 0u ) && ( spans.empty() || spans[0].offset == pos );
+		}
+	}
+
+	check ( all_bytes , "every byte value" );
+
+	delete p;
+
+	return check.result();
+}
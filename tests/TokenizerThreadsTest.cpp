@@ -0,0 +1,118 @@
+/**
+* Tokenizing and matching from several threads at once: one compiled Pattern
+* shared by all of them (createMatcher, findAll, matches), another kept in
+* the pattern cache by the first thread asking for it, and the token
+* scorers, each thread getting what a single thread gets.
+*/
+//   g++ -std=c++17 -O2 -pthread -I.. -I../RegularExpressions ../*.cpp ../RegularExpressions/Pattern.cpp ../RegularExpressions/Matcher.cpp TokenizerThreadsTest.cpp -o TokenizerThreadsTest
+
+#include "Test.h"
+#include "FuzzyWuzzy.h"
+#include "Tokenizer.h"
+#include "RegularExpressions/regexp/Matcher.h"
+#include "RegularExpressions/regexp/Pattern.h"
+#include <atomic>
+#include <thread>
+
+using namespace FuzzyWuzzy;
+
+/* what one thread computes for a string */
+struct Result
+{
+	std::vector<std::string> tokens , matched , found , pieces;
+	bool                     whole;
+	double                   sort_score , set_score;
+
+	bool operator== ( const Result& r ) const
+	{
+		return tokens == r.tokens && matched == r.matched && found == r.found && pieces == r.pieces &&
+			   whole == r.whole && sort_score == r.sort_score && set_score == r.set_score;
+	}
+};
+
+static Result _run ( Pattern* p , const std::string& s , const std::string& other )
+{
+	Result                 r;
+	std::vector<TokenSpan> spans;
+
+	find_tokens ( s , spans );
+	for ( const TokenSpan& span : spans )
+		r.tokens.push_back ( s.substr ( span.offset , span.length ) );
+
+	Matcher* m = p->createMatcher ( s );
+
+	r.matched = m->findAll();
+	delete m;
+
+	r.found      = p->findAll ( s );
+	r.whole      = p->matches ( s );
+	r.pieces     = Pattern::compileAndKeep ( "[^\\w\\d]+" )->split ( s );
+	r.sort_score = token_sort_ratio ( s , other );
+	r.set_score  = token_set_ratio ( s , other );
+
+	return r;
+}
+
+int main ( void )
+{
+	test::Random rng ( 9 );
+	test::Check  check ( "TokenizerThreadsTest" );
+
+	const std::string alphabet = "abc 12_,.-\xE9";
+
+	Pattern* p = Pattern::compile ( "[\\w\\d]+" );
+
+	std::vector<std::string> strings;
+
+	for ( size_t i = 0 ; i < 300 ; i++ )
+		strings.push_back ( rng.string ( rng.below ( 150 ) , alphabet ) );
+
+	std::vector<Result> expected;
+
+	for ( size_t i = 0 ; i < strings.size() ; i++ )
+		expected.push_back ( _run ( p , strings[i] , strings[( i + 1 ) % strings.size()] ) );
+
+	check ( expected[0].tokens == expected[0].matched && expected[0].matched == expected[0].found , "find_tokens and findAll agree" );
+
+	// the cache is empty again when the threads start
+	Pattern::clearPatternCache();
+
+	const size_t threads = 8;
+
+	std::vector<std::thread> running;
+	std::vector<size_t>      mismatches ( threads , 0 );
+	std::atomic<size_t>      ready ( 0 );
+
+	for ( size_t t = 0 ; t < threads ; t++ )
+	{
+		running.emplace_back ( [& , t] ()
+		{
+			ready++;
+			while ( ready.load() < threads )
+				std::this_thread::yield();
+
+			for ( int round = 0 ; round < 10 ; round++ )
+			{
+				// every thread walks the strings from its own place
+				for ( size_t k = 0 ; k < strings.size() ; k++ )
+				{
+					size_t i = ( k + t * 37 ) % strings.size();
+
+					if ( !( _run ( p , strings[i] , strings[( i + 1 ) % strings.size()] ) == expected[i] ) )
+						mismatches[t]++;
+				}
+			}
+		} );
+	}
+
+	for ( std::thread& thread : running )
+		thread.join();
+
+	for ( size_t t = 0 ; t < threads ; t++ )
+		check ( mismatches[t] == 0 , "the same results as one thread" );
+
+	Pattern::clearPatternCache();
+	delete p;
+
+	return check.result();
+}
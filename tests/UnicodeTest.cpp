@@ -0,0 +1,269 @@
+/**
+* The code point scorers against the byte ones on the same text, the cached
+* and UTF-8 ones against the free functions, and the code point BKTree,
+* SymSpellIndex and MinHash against brute force and the byte behavior.
+*/
+//   g++ -std=c++17 -O2 -pthread -I.. ../*.cpp UnicodeTest.cpp -o UnicodeTest
+
+#include "Test.h"
+#include "Process.h"
+#include "BKTree.h"
+#include "SymSpellIndex.h"
+#include "MinHash.h"
+
+using namespace FuzzyWuzzy;
+
+/* the bytes of s as code points */
+template <typename String>
+static String _widen ( const std::string& s )
+{
+	String wide;
+
+	for ( char ch : s )
+		wide += (typename String::value_type)(unsigned char) ch;
+
+	return wide;
+}
+
+static std::u16string _u16 ( const std::u32string& s )
+{
+	return std::u16string ( s.begin() , s.end() );
+}
+
+/* words, punctuation and code points of every UTF-8 length */
+static std::string _text ( test::Random& rng , size_t words )
+{
+	static const char* pieces[] = { "a" , "b" , "c" , "é" , "É" , "ß" , "я" , "Я" , "日" , "本" , "😀" , "x" , "-" , "!" };
+
+	std::string s;
+
+	for ( size_t i = 0 ; i < words ; i++ )
+	{
+		if ( i > 0 )
+			s += rng.below ( 4 ) ? " " : "  ";
+		for ( size_t j = rng.range ( 1 , 5 ) ; j > 0 ; j-- )
+			s += pieces[rng.below ( 14 )];
+	}
+
+	return s;
+}
+
+/* the same scores on the bytes, their char16_t and their char32_t */
+static void _check_widths ( test::Check& check , test::Random& rng )
+{
+	// ASCII, where bytes and code points process alike
+	const std::string alphabet = "abcdeABC -,.!";
+
+	for ( int it = 0 ; it < 2000 ; it++ )
+	{
+		std::string a = rng.string ( rng.below ( it % 7 == 0 ? 150 : 30 ) , alphabet );
+		std::string b = it % 3 ? rng.mutate ( a , rng.below ( 8 ) , alphabet ) : rng.string ( rng.below ( 30 ) , alphabet );
+
+		std::u16string a16 = _widen<std::u16string> ( a ) , b16 = _widen<std::u16string> ( b );
+		std::u32string a32 = _widen<std::u32string> ( a ) , b32 = _widen<std::u32string> ( b );
+
+		double cutoff = (double) rng.below ( 100 );
+
+		double bytes[] = { ratio ( a , b ) , ratio ( a , b , cutoff ) , partial_ratio ( a , b ) , partial_ratio ( a , b , cutoff ) ,
+						   token_sort_ratio ( a , b ) , partial_token_sort_ratio ( a , b ) ,
+						   token_set_ratio ( a , b ) , partial_token_set_ratio ( a , b ) , WRatio ( a , b ) };
+		double u16[]   = { ratio ( a16 , b16 ) , ratio ( a16 , b16 , cutoff ) , partial_ratio ( a16 , b16 ) , partial_ratio ( a16 , b16 , cutoff ) ,
+						   token_sort_ratio ( a16 , b16 ) , partial_token_sort_ratio ( a16 , b16 ) ,
+						   token_set_ratio ( a16 , b16 ) , partial_token_set_ratio ( a16 , b16 ) , WRatio ( a16 , b16 ) };
+		double u32[]   = { ratio ( a32 , b32 ) , ratio ( a32 , b32 , cutoff ) , partial_ratio ( a32 , b32 ) , partial_ratio ( a32 , b32 , cutoff ) ,
+						   token_sort_ratio ( a32 , b32 ) , partial_token_sort_ratio ( a32 , b32 ) ,
+						   token_set_ratio ( a32 , b32 ) , partial_token_set_ratio ( a32 , b32 ) , WRatio ( a32 , b32 ) };
+
+		for ( size_t k = 0 ; k < 9 ; k++ )
+			check ( bytes[k] == u16[k] && bytes[k] == u32[k] , "char16_t and char32_t scores" , a , b );
+
+		for ( int xcost = 0 ; xcost <= 1 ; xcost++ )
+		{
+			size_t expected = test::reference_distance ( a , b , xcost );
+			size_t max      = rng.below ( 20 );
+
+			check ( lev_edit_distance ( a32.length() , a32.data() , b32.length() , b32.data() , xcost ) == expected , "lev_edit_distance char32_t" , a , b );
+			check ( lev_edit_distance ( a16.length() , a16.data() , b16.length() , b16.data() , xcost , max ) == std::min ( expected , max + 1 ) ,
+					"lev_edit_distance char16_t with max" , a , b );
+		}
+	}
+}
+
+/* scorer and its cached and UTF-8 forms on every pair of texts */
+template <typename U32Cached , typename U16Cached , typename UTF8Cached , typename F>
+static void _check_cached ( test::Check& check , const char* what , const std::vector<std::string>& texts , F f )
+{
+	for ( const std::string& a : texts )
+	{
+		std::u32string a32 = utf8_decode ( a );
+
+		U32Cached  cached32 ( a32 );
+		U16Cached  cached16 ( _u16 ( a32 ) );
+		UTF8Cached cached8 ( a );
+
+		for ( const std::string& b : texts )
+		{
+			std::u32string b32      = utf8_decode ( b );
+			double         expected = f ( a32 , b32 );
+
+			check ( cached32.similarity ( b32 ) == expected , what , a , b );
+			check ( cached16.similarity ( _u16 ( b32 ) ) == f ( _u16 ( a32 ) , _u16 ( b32 ) ) , what , a , b );
+			check ( cached8.similarity ( b ) == expected , what , a , b );
+			check ( cached8.similarity ( U32TokenizedString ( b32 ) ) == expected , what , a , b );
+			check ( cached8.similarity ( b , expected ) == expected , what , a , b );
+			check ( expected + 0.5 > 100 || cached8.similarity ( b , expected + 0.5 ) == 0 , what , a , b );
+		}
+	}
+}
+
+/* the code point indexes against the distance of every term */
+static void _check_indexes ( test::Check& check , test::Random& rng )
+{
+	const std::u32string alphabet = U"abcéßя日本😀 ";
+
+	std::vector<std::u32string> terms;
+
+	for ( size_t i = 0 ; i < 3000 ; i++ )
+		terms.push_back ( rng.string ( rng.below ( 9 ) , alphabet ) );
+
+	ThreadPool       pool ( 4 );
+	U32BKTree        tree ( terms );
+	U32SymSpellIndex symspell ( terms , 2 , 5 );
+
+	std::vector<BKTreeMatch>   found , found_pool;
+	std::vector<SymSpellMatch> suggested;
+
+	for ( int it = 0 ; it < 200 ; it++ )
+	{
+		std::u32string query = rng.string ( rng.below ( 9 ) , alphabet );
+		size_t         k     = it % 3;
+
+		std::vector< std::pair<size_t,size_t> > expected;
+
+		for ( size_t i = 0 ; i < terms.size() ; i++ )
+		{
+			size_t d = test::reference_distance ( query , terms[i] , 0 );
+
+			if ( d <= k )
+				expected.push_back ( { d , i } );
+		}
+		std::sort ( expected.begin() , expected.end() );
+
+		tree.find ( query , k , found );
+		tree.find ( pool , query , k , found_pool );
+		symspell.find ( query , k , suggested );
+
+		bool same = found.size() == expected.size() && found_pool.size() == expected.size() && suggested.size() == expected.size();
+
+		for ( size_t i = 0 ; same && i < expected.size() ; i++ )
+			same = found[i].distance == expected[i].first && found[i].id == expected[i].second &&
+				   found_pool[i].id == expected[i].second &&
+				   suggested[i].distance == expected[i].first && suggested[i].id == expected[i].second;
+
+		check ( same , "U32BKTree and U32SymSpellIndex" , utf8_encode ( query ) , "" );
+	}
+
+	U16BKTree                u16tree;
+	std::vector<BKTreeMatch> u16found;
+
+	u16tree.insert ( u"日本語" );
+	u16tree.insert ( u"日本" );
+	u16tree.find ( u"日本x" , 1 , u16found );
+	check ( u16found.size() == 2 , "U16BKTree" );
+
+	// MinHash on code points: the same token sets give the same signature
+	MinHash               minhash ( 64 , 1 );
+	std::vector<uint32_t> sig1 ( 64 ) , sig2 ( 64 );
+
+	minhash.signature ( std::u32string ( U"Été été  日本" ) , sig1.data() );
+	minhash.signature ( std::u32string ( U"日本 Été été" ) , sig2.data() );
+	check ( sig1 == sig2 , "MinHash signature of code points" );
+
+	std::vector<std::u32string> docs;
+
+	for ( size_t i = 0 ; i < 300 ; i++ )
+		docs.push_back ( rng.string ( rng.below ( 20 ) , alphabet ) );
+
+	std::vector<uint32_t> sigs;
+
+	minhash.signatures ( pool , docs , sigs );
+	minhash.signature ( docs[5] , sig1.data() );
+	check ( std::equal ( sig1.begin() , sig1.end() , sigs.begin() + 5 * 64 ) , "MinHash signatures on a pool" );
+
+	MinHashLSH lsh ( 8 , 2 );
+
+	for ( size_t i = 0 ; i < docs.size() ; i++ )
+		lsh.add ( (uint32_t) i , docs[i] );
+	lsh.build();
+
+	std::vector< std::pair<uint32_t,uint32_t> > pairs;
+	std::vector<ScoredPair>                     verified , verified_pool;
+
+	lsh.candidate_pairs ( pairs );
+	verify_pairs ( docs , pairs , 50 , verified );
+	verify_pairs ( pool , docs , pairs , 50 , verified_pool );
+
+	check ( verified.size() == verified_pool.size() , "verify_pairs of code points on a pool" );
+	for ( const ScoredPair& pair : verified )
+		check ( pair.score == token_set_ratio ( docs[pair.first] , docs[pair.second] ) , "verify_pairs of code points" );
+}
+
+int main ( void )
+{
+	test::Random rng ( 15 );
+	test::Check  check ( "UnicodeTest" );
+
+	_check_widths ( check , rng );
+
+	std::vector<std::string> texts;
+
+	for ( size_t i = 0 ; i < 80 ; i++ )
+		texts.push_back ( _text ( rng , rng.below ( 5 ) ) );
+
+	_check_cached<U32CachedRatio , U16CachedRatio , utf8::CachedRatio> ( check , "CachedRatio" , texts ,
+		[] ( const auto& a , const auto& b ) { return ratio ( a , b ); } );
+	_check_cached<U32CachedPartialRatio , U16CachedPartialRatio , utf8::CachedPartialRatio> ( check , "CachedPartialRatio" , texts ,
+		[] ( const auto& a , const auto& b ) { return partial_ratio ( a , b ); } );
+	_check_cached<U32CachedTokenSortRatio , U16CachedTokenSortRatio , utf8::CachedTokenSortRatio> ( check , "CachedTokenSortRatio" , texts ,
+		[] ( const auto& a , const auto& b ) { return token_sort_ratio ( a , b ); } );
+	_check_cached<U32CachedPartialTokenSortRatio , U16CachedPartialTokenSortRatio , utf8::CachedPartialTokenSortRatio> ( check , "CachedPartialTokenSortRatio" , texts ,
+		[] ( const auto& a , const auto& b ) { return partial_token_sort_ratio ( a , b ); } );
+	_check_cached<U32CachedTokenSetRatio , U16CachedTokenSetRatio , utf8::CachedTokenSetRatio> ( check , "CachedTokenSetRatio" , texts ,
+		[] ( const auto& a , const auto& b ) { return token_set_ratio ( a , b ); } );
+	_check_cached<U32CachedPartialTokenSetRatio , U16CachedPartialTokenSetRatio , utf8::CachedPartialTokenSetRatio> ( check , "CachedPartialTokenSetRatio" , texts ,
+		[] ( const auto& a , const auto& b ) { return partial_token_set_ratio ( a , b ); } );
+	_check_cached<U32CachedWRatio , U16CachedWRatio , utf8::CachedWRatio> ( check , "CachedWRatio" , texts ,
+		[] ( const auto& a , const auto& b ) { return WRatio ( a , b ); } );
+
+	// the UTF-8 functions decode, cdist decodes the choices once
+	for ( const std::string& a : texts )
+		for ( const std::string& b : texts )
+			check ( utf8::WRatio ( a , b ) == WRatio ( utf8_decode ( a ) , utf8_decode ( b ) ) &&
+					utf8::token_set_ratio ( a , b ) == token_set_ratio ( utf8_decode ( a ) , utf8_decode ( b ) ) , "utf8 functions" , a , b );
+
+	ThreadPool pool ( 4 );
+
+	process::Matrix<float> set_matrix   = process::cdist<float> ( pool , texts , texts , process::Cached<utf8::CachedTokenSetRatio>() , 0 );
+	process::Matrix<float> ratio_matrix = process::cdist<float> ( pool , texts , texts , process::Cached<utf8::CachedRatio>() , 50 );
+
+	for ( size_t i = 0 ; i < texts.size() ; i++ )
+	{
+		for ( size_t j = 0 ; j < texts.size() ; j++ )
+		{
+			std::u32string a = utf8_decode ( texts[i] ) , b = utf8_decode ( texts[j] );
+			double         r = ratio ( a , b );
+
+			check ( set_matrix ( i , j ) == (float) token_set_ratio ( a , b ) , "cdist utf8::CachedTokenSetRatio" , texts[i] , texts[j] );
+			check ( ratio_matrix ( i , j ) == (float) ( r >= 50 ? r : 0 ) , "cdist utf8::CachedRatio" , texts[i] , texts[j] );
+		}
+	}
+
+	// UTF-8 round trip and case folding past ASCII
+	for ( const std::string& text : texts )
+		check ( utf8_encode ( utf8_decode ( text ) ) == text , "utf8 round trip" , text , "" );
+	check ( utf8::full_process ( " ÉCOLE-Été! " ) == "école été" , "utf8::full_process" );
+
+	_check_indexes ( check , rng );
+
+	return check.result();
+}
@@ -0,0 +1,96 @@
+/**
+* WRatio against weighing the scores of the separate functions as the
+* original did, with and without score_cutoff, cached and on pretokenized
+* choices.
+*/
+//   g++ -std=c++17 -O2 -pthread -I.. ../*.cpp WRatioTest.cpp -o WRatioTest
+
+#include "Test.h"
+#include "FuzzyWuzzy.h"
+
+using namespace FuzzyWuzzy;
+
+/* every sub-score computed on its own */
+static double _reference_wratio ( const std::string& s1 , const std::string& s2 )
+{
+	if ( s1.empty() || s2.empty() )
+		return 0;
+
+	double unbase_scale  = 0.95;
+	double partial_scale = 0.90;
+	double len_ratio     = (double) std::max ( s1.length() , s2.length() ) /
+						   (double) std::min ( s1.length() , s2.length() );
+
+	if ( len_ratio > 8 )
+		partial_scale = 0.6;
+
+	if ( len_ratio < 1.5 )
+		return std::max ( token_sort_ratio ( s1 , s2 ) * unbase_scale , token_set_ratio ( s1 , s2 ) * unbase_scale );
+
+	return std::max ( std::max ( ratio ( s1 , s2 ) , partial_ratio ( s1 , s2 ) * partial_scale ) ,
+					  std::max ( partial_token_sort_ratio ( s1 , s2 ) * unbase_scale * partial_scale ,
+								 partial_token_set_ratio  ( s1 , s2 ) * unbase_scale * partial_scale ) );
+}
+
+/* words, sometimes cut or misspelled, so that every branch wins now and then */
+static std::string _text ( test::Random& rng )
+{
+	static const char* words[] = { "new" , "york" , "mets" , "yankees" , "st" , "street" , "a" , "42" ,
+								   "acme" , "inc" , "foo" , "fooo" , "bar" , "baz" , "the" , "of" };
+
+	std::string s;
+
+	for ( size_t i = rng.below ( rng.below ( 6 ) == 0 ? 30 : 6 ) ; i > 0 ; i-- )
+	{
+		s += rng.below ( 6 ) == 0 ? rng.mutate ( std::string ( words[rng.below ( 16 )] ) , 1 , std::string ( "aeiou" ) ) :
+									std::string ( words[rng.below ( 16 )] );
+		if ( i > 1 )
+			s += rng.below ( 5 ) ? " " : ", ";
+	}
+
+	return s;
+}
+
+int main ( void )
+{
+	test::Random rng ( 18 );
+	test::Check  check ( "WRatioTest" );
+
+	for ( int it = 0 ; it < 10000 ; it++ )
+	{
+		std::string s1 = _text ( rng );
+		std::string s2;
+
+		// similar lengths, one and a half to eight times, and beyond
+		switch ( it % 4 )
+		{
+			case 0 :  s2 = _text ( rng ); break;
+			case 1 :  s2 = s1 + " " + _text ( rng ); break;
+			case 2 :  s2 = rng.mutate ( s1 , rng.below ( 4 ) , std::string ( "abc " ) ); break;
+			default : s2 = s1.substr ( 0 , rng.below ( s1.length() / 8 + 2 ) ); break;
+		}
+
+		if ( rng.below ( 2 ) )
+			std::swap ( s1 , s2 );
+
+		double expected = _reference_wratio ( s1 , s2 );
+
+		check ( WRatio ( s1 , s2 ) == expected , "WRatio" , s1 , s2 );
+
+		TokenizedString tokenized ( s2 );
+		CachedWRatio    cached ( s1 );
+
+		double cutoffs[] = { 0 , (double) rng.below ( 101 ) , expected };
+
+		for ( double cutoff : cutoffs )
+		{
+			double want = expected >= cutoff ? expected : 0;
+
+			check ( WRatio ( s1 , s2 , cutoff ) == want , "WRatio with score_cutoff" , s1 , s2 );
+			check ( cached.similarity ( s2 , cutoff ) == want , "CachedWRatio" , s1 , s2 );
+			check ( cached.similarity ( tokenized , cutoff ) == want , "CachedWRatio pretokenized" , s1 , s2 );
+		}
+	}
+
+	return check.result();
+}